@@ -19,11 +19,17 @@ void* URCL_realloc(void* ptr, size_t size);
 ////description An interface for freeing memory. This function must be defined by the consumer if the URCL_NoDependencies macro is defined.
 void URCL_free(void* ptr);
 
-#ifdef URCL_NoChar16
+#if defined(URCL_Utf8)
+	typedef unsigned char URCL_Char;
+	#define URCL_Text(text) ((const URCL_Char*)text)
+#elif defined(URCL_NoChar16)
 	typedef unsigned short URCL_Char;
+	#define URCL_Text(text) u ## text
 #else
-	////description Defines URCL_Char as a char16_t. URCL_Char can be defined as unsigned short instead if the URCL_NoChar16 macro is defined.
+	////description Defines URCL_Char as a char16_t holding UTF-16 code units. URCL_Char can be defined as unsigned short instead if the URCL_NoChar16 macro is defined, or as an unsigned char holding UTF-8 code units if the URCL_Utf8 macro is defined.
 	typedef char16_t URCL_Char;
+	////description Converts an ASCII string literal into a URCL_Char string literal.
+	#define URCL_Text(text) u ## text
 #endif
 
 #ifndef URCL_NoDependencies
@@ -36,6 +42,25 @@ void URCL_free(void* ptr);
 	void URCL_free(void* ptr) { free(ptr); }
 #endif
 
+#if !defined(URCL_NoDependencies) && !defined(URCL_NoFiles) && (defined(__unix__) || defined(__APPLE__))
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+
+	////description Defined if the file parsing functions are available. Files are supported on POSIX systems unless the URCL_NoDependencies or URCL_NoFiles macro is defined.
+	#define URCL_Files
+#endif
+
+#if !defined(URCL_NoDependencies) && !defined(URCL_NoSimd) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+	#include <emmintrin.h>
+
+	////description Defined if the whitespace, operand, line, and comment scanners test 16 bytes per step with SSE2, which is 8 UTF-16 or 16 UTF-8 code units. SSE2 is used when the compiler targets it unless the URCL_NoDependencies or URCL_NoSimd macro is defined, and 64-bit SWAR is used otherwise. Wider AVX2 steps are not used, since the tokens and whitespace runs of a line rarely fill 32 bytes and AVX2 needs a separate build target.
+	#define URCL_Sse2
+#endif
+
 #ifndef __cplusplus
 	typedef int bool;
 	#define true 1
@@ -63,6 +88,167 @@ void URCL_free(void* ptr);
 #define URCL_OperandType_Port 7
 ////description Specifies a generic operand.
 #define URCL_OperandType_Any 8
+////description Specifies a run of DW words stored in the data segment of the parser. The immediate value is the index of its range in the data segment.
+#define URCL_OperandType_Data 9
+
+////description Specifies an unknown operation.
+#define URCL_Opcode_Unknown 0
+////description Specifies the ADD instruction.
+#define URCL_Opcode_Add 1
+////description Specifies the RSH instruction.
+#define URCL_Opcode_Rsh 2
+////description Specifies the LOD instruction.
+#define URCL_Opcode_Lod 3
+////description Specifies the STR instruction.
+#define URCL_Opcode_Str 4
+////description Specifies the BGE instruction.
+#define URCL_Opcode_Bge 5
+////description Specifies the NOR instruction.
+#define URCL_Opcode_Nor 6
+////description Specifies the IMM instruction.
+#define URCL_Opcode_Imm 7
+////description Specifies the SUB instruction.
+#define URCL_Opcode_Sub 8
+////description Specifies the JMP instruction.
+#define URCL_Opcode_Jmp 9
+////description Specifies the MOV instruction.
+#define URCL_Opcode_Mov 10
+////description Specifies the NOP instruction.
+#define URCL_Opcode_Nop 11
+////description Specifies the LSH instruction.
+#define URCL_Opcode_Lsh 12
+////description Specifies the INC instruction.
+#define URCL_Opcode_Inc 13
+////description Specifies the DEC instruction.
+#define URCL_Opcode_Dec 14
+////description Specifies the NEG instruction.
+#define URCL_Opcode_Neg 15
+////description Specifies the AND instruction.
+#define URCL_Opcode_And 16
+////description Specifies the OR instruction.
+#define URCL_Opcode_Or 17
+////description Specifies the NOT instruction.
+#define URCL_Opcode_Not 18
+////description Specifies the XNOR instruction.
+#define URCL_Opcode_Xnor 19
+////description Specifies the XOR instruction.
+#define URCL_Opcode_Xor 20
+////description Specifies the NAND instruction.
+#define URCL_Opcode_Nand 21
+////description Specifies the BRL instruction.
+#define URCL_Opcode_Brl 22
+////description Specifies the BRG instruction.
+#define URCL_Opcode_Brg 23
+////description Specifies the BRE instruction.
+#define URCL_Opcode_Bre 24
+////description Specifies the BNE instruction.
+#define URCL_Opcode_Bne 25
+////description Specifies the BOD instruction.
+#define URCL_Opcode_Bod 26
+////description Specifies the BEV instruction.
+#define URCL_Opcode_Bev 27
+////description Specifies the BLE instruction.
+#define URCL_Opcode_Ble 28
+////description Specifies the BRZ instruction.
+#define URCL_Opcode_Brz 29
+////description Specifies the BNZ instruction.
+#define URCL_Opcode_Bnz 30
+////description Specifies the BRN instruction.
+#define URCL_Opcode_Brn 31
+////description Specifies the BRP instruction.
+#define URCL_Opcode_Brp 32
+////description Specifies the PSH instruction.
+#define URCL_Opcode_Psh 33
+////description Specifies the POP instruction.
+#define URCL_Opcode_Pop 34
+////description Specifies the CAL instruction.
+#define URCL_Opcode_Cal 35
+////description Specifies the RET instruction.
+#define URCL_Opcode_Ret 36
+////description Specifies the HLT instruction.
+#define URCL_Opcode_Hlt 37
+////description Specifies the CPY instruction.
+#define URCL_Opcode_Cpy 38
+////description Specifies the BRC instruction.
+#define URCL_Opcode_Brc 39
+////description Specifies the BNC instruction.
+#define URCL_Opcode_Bnc 40
+////description Specifies the MLT instruction.
+#define URCL_Opcode_Mlt 41
+////description Specifies the DIV instruction.
+#define URCL_Opcode_Div 42
+////description Specifies the MOD instruction.
+#define URCL_Opcode_Mod 43
+////description Specifies the BSR instruction.
+#define URCL_Opcode_Bsr 44
+////description Specifies the BSL instruction.
+#define URCL_Opcode_Bsl 45
+////description Specifies the SRS instruction.
+#define URCL_Opcode_Srs 46
+////description Specifies the BSS instruction.
+#define URCL_Opcode_Bss 47
+////description Specifies the SETE instruction.
+#define URCL_Opcode_Sete 48
+////description Specifies the SETNE instruction.
+#define URCL_Opcode_Setne 49
+////description Specifies the SETG instruction.
+#define URCL_Opcode_Setg 50
+////description Specifies the SETL instruction.
+#define URCL_Opcode_Setl 51
+////description Specifies the SETGE instruction.
+#define URCL_Opcode_Setge 52
+////description Specifies the SETLE instruction.
+#define URCL_Opcode_Setle 53
+////description Specifies the SETC instruction.
+#define URCL_Opcode_Setc 54
+////description Specifies the SETNC instruction.
+#define URCL_Opcode_Setnc 55
+////description Specifies the LLOD instruction.
+#define URCL_Opcode_Llod 56
+////description Specifies the LSTR instruction.
+#define URCL_Opcode_Lstr 57
+////description Specifies the SDIV instruction.
+#define URCL_Opcode_Sdiv 58
+////description Specifies the SBRL instruction.
+#define URCL_Opcode_Sbrl 59
+////description Specifies the SBRG instruction.
+#define URCL_Opcode_Sbrg 60
+////description Specifies the SBLE instruction.
+#define URCL_Opcode_Sble 61
+////description Specifies the SBGE instruction.
+#define URCL_Opcode_Sbge 62
+////description Specifies the SSETL instruction.
+#define URCL_Opcode_Ssetl 63
+////description Specifies the SSETG instruction.
+#define URCL_Opcode_Ssetg 64
+////description Specifies the SSETLE instruction.
+#define URCL_Opcode_Ssetle 65
+////description Specifies the SSETGE instruction.
+#define URCL_Opcode_Ssetge 66
+////description Specifies the ABS instruction.
+#define URCL_Opcode_Abs 67
+////description Specifies the UMLT instruction.
+#define URCL_Opcode_Umlt 68
+////description Specifies the SUMLT instruction.
+#define URCL_Opcode_Sumlt 69
+////description Specifies the IN instruction.
+#define URCL_Opcode_In 70
+////description Specifies the OUT instruction.
+#define URCL_Opcode_Out 71
+////description Specifies the DW instruction.
+#define URCL_Opcode_Dw 72
+////description Specifies the BITS header.
+#define URCL_Opcode_Bits 73
+////description Specifies the MINREG header.
+#define URCL_Opcode_MinimumRegisters 74
+////description Specifies the MINHEAP header.
+#define URCL_Opcode_MinimumHeap 75
+////description Specifies the MINSTACK header.
+#define URCL_Opcode_MinimumStack 76
+////description Specifies the RUN header.
+#define URCL_Opcode_InstructionStorage 77
+////description The number of opcodes, including URCL_Opcode_Unknown.
+#define URCL_OpcodeCount 78
 
 ////description Represents an URCL operand.
 typedef struct URCL_OperandInfo
@@ -76,15 +262,30 @@ typedef struct URCL_OperandInfo
 	////class URCL_OperandInfo
 	////description The string value of the operand.
 	URCL_Char* StringValue;
+	////class URCL_OperandInfo
+	////description The length of the string value, excluding any null terminator.
+	size_t StringLength;
+	////class URCL_OperandInfo
+	////description True if the string value is a view into the parsed source and is not null-terminated, or false if the string value is owned by the operand.
+	bool IsSourceView;
 } URCL_OperandInfo;
 
 ////description Represents an URCL instruction or header.
 typedef struct URCL_InstructionInfo
 {
 	////class URCL_InstructionInfo
-	////description The name of the instruction.
+	////description The name of the instruction. Known instructions and headers use the canonical upper-case name from URCL_OpcodeNames.
 	URCL_Char* Operation;
 	////class URCL_InstructionInfo
+	////description The length of the name of the instruction, excluding any null terminator.
+	size_t OperationLength;
+	////class URCL_InstructionInfo
+	////description True if the name of the instruction is not owned by the instruction, either because it is a view into the parsed source and is not null-terminated or because it is a canonical name, or false if the name is owned by the instruction.
+	bool IsSourceView;
+	////class URCL_InstructionInfo
+	////description The opcode of the instruction, or URCL_Opcode_Unknown if the name is not a known instruction or header.
+	unsigned long Opcode;
+	////class URCL_InstructionInfo
 	////description An array of the instruction's operands.
 	URCL_OperandInfo Operands[URCL_MaxOperands];
 } URCL_InstructionInfo;
@@ -96,24 +297,216 @@ typedef struct URCL_LabelInfo
 	////description The name of the label.
 	URCL_Char* Name;
 	////class URCL_LabelInfo
+	////description The length of the name of the label, excluding any null terminator.
+	size_t NameLength;
+	////class URCL_LabelInfo
+	////description True if the name of the label is a view into the parsed source and is not null-terminated, or false if the name is owned by the label.
+	bool IsSourceView;
+	////class URCL_LabelInfo
 	////description The address of the label.
 	unsigned long long Address;
 } URCL_LabelInfo;
 
-////description Frees all instructions in the specified array.
-void URCL_FreeInstructions(URCL_InstructionInfo* instructions, unsigned long count)
+void* URCL_memcpy(void* dest, const void* src, size_t n)
+{
+	for (size_t i = 0; i < n; i++) ((char*)dest)[i] = ((char*)src)[i];
+	return dest;
+}
+
+void* URCL_memmove(void* dest, const void* src, size_t n)
+{
+	if ((char*)dest == (const char*)src) return dest;
+
+	if (((((size_t)dest) | ((size_t)src) | n) % sizeof(size_t)) == 0)
+	{
+		size_t words = n / sizeof(size_t);
+		if ((char*)dest < (const char*)src) for (size_t i = 0; i < words; i++) ((size_t*)dest)[i] = ((const size_t*)src)[i];
+		else for (size_t i = words; i > 0; i--) ((size_t*)dest)[i - 1] = ((const size_t*)src)[i - 1];
+	}
+	else
+	{
+		if ((char*)dest < (const char*)src) for (size_t i = 0; i < n; i++) ((char*)dest)[i] = ((const char*)src)[i];
+		else for (size_t i = n; i > 0; i--) ((char*)dest)[i - 1] = ((const char*)src)[i - 1];
+	}
+	return dest;
+}
+
+size_t URCL_GetReservedCapacity(size_t capacity, size_t count, size_t itemSize)
+{
+	if ((itemSize == 0) || (count > ((size_t)-1 / itemSize))) return 0;
+
+	size_t newCapacity = capacity > 0 ? capacity : 16;
+	while (newCapacity < count) newCapacity = (newCapacity <= ((size_t)-1 / 2)) ? newCapacity * 2 : count;
+	if (newCapacity > ((size_t)-1 / itemSize)) newCapacity = count;
+	return newCapacity;
+}
+
+bool URCL_TryReserveArray(void** items, size_t* capacity, size_t count, size_t itemSize)
+{
+	if ((*items != 0) && (count <= *capacity)) return true;
+
+	size_t newCapacity = URCL_GetReservedCapacity(*capacity, count, itemSize);
+	if (newCapacity == 0) return false;
+
+	void* resized = URCL_realloc(*items, newCapacity * itemSize);
+	if (resized == 0) return false;
+
+	*items = resized;
+	*capacity = newCapacity;
+	return true;
+}
+
+////description The default number of bytes in each block allocated by an arena.
+#define URCL_ArenaBlockSize 65536
+////description The alignment in bytes of every allocation made by an arena.
+#define URCL_ArenaAlignment 16
+
+////description Represents a block of memory owned by an arena. The usable memory immediately follows the block header.
+typedef struct URCL_ArenaBlock
+{
+	////class URCL_ArenaBlock
+	////description The block that was allocated before this block, or null if this is the first block.
+	struct URCL_ArenaBlock* Previous;
+	////class URCL_ArenaBlock
+	////description The number of usable bytes in the block.
+	size_t Capacity;
+	////class URCL_ArenaBlock
+	////description The number of bytes that have been allocated from the block.
+	size_t Used;
+	////class URCL_ArenaBlock
+	////description The offset of the last allocation made from the block.
+	size_t Last;
+} URCL_ArenaBlock;
+
+////description Represents a bump allocator that releases all of its allocations at once.
+typedef struct URCL_Arena
+{
+	////class URCL_Arena
+	////description The most recently allocated block, or null if the arena is empty.
+	URCL_ArenaBlock* Blocks;
+	////class URCL_Arena
+	////description The number of bytes in each block allocated by the arena.
+	size_t BlockSize;
+} URCL_Arena;
+
+size_t URCL_ArenaAlign(size_t size)
+{
+	return (size + (URCL_ArenaAlignment - 1)) & ~((size_t)(URCL_ArenaAlignment - 1));
+}
+
+char* URCL_ArenaBlockData(URCL_ArenaBlock* block)
+{
+	return ((char*)block) + URCL_ArenaAlign(sizeof(URCL_ArenaBlock));
+}
+
+////description Initializes an empty arena that allocates blocks of the specified size, or blocks of URCL_ArenaBlockSize if the size is 0.
+void URCL_InitArena(URCL_Arena* arena, size_t blockSize)
+{
+	arena->Blocks = 0;
+	arena->BlockSize = blockSize == 0 ? URCL_ArenaBlockSize : URCL_ArenaAlign(blockSize);
+}
+
+////description Allocates memory from the specified arena. Returns null if out of memory.
+void* URCL_ArenaAlloc(URCL_Arena* arena, size_t size)
+{
+	size = URCL_ArenaAlign(size);
+	URCL_ArenaBlock* block = arena->Blocks;
+
+	if (block == 0 || (block->Capacity - block->Used) < size)
+	{
+		size_t capacity = size > arena->BlockSize ? size : arena->BlockSize;
+		block = (URCL_ArenaBlock*)URCL_malloc(URCL_ArenaAlign(sizeof(URCL_ArenaBlock)) + capacity);
+		if (block == 0) return 0;
+
+		block->Capacity = capacity;
+		block->Used = 0;
+		block->Last = 0;
+
+		if (capacity > arena->BlockSize && arena->Blocks != 0)
+		{
+			block->Previous = arena->Blocks->Previous;
+			arena->Blocks->Previous = block;
+		}
+		else
+		{
+			block->Previous = arena->Blocks;
+			arena->Blocks = block;
+		}
+	}
+
+	block->Last = block->Used;
+	block->Used += size;
+	return URCL_ArenaBlockData(block) + block->Last;
+}
+
+////description Resizes memory allocated from the specified arena. The memory is resized in place if it was the last allocation made from the arena. Returns null if out of memory.
+void* URCL_ArenaRealloc(URCL_Arena* arena, void* ptr, size_t oldSize, size_t newSize)
+{
+	if (ptr == 0) return URCL_ArenaAlloc(arena, newSize);
+
+	URCL_ArenaBlock* block = arena->Blocks;
+	if (block != 0 && block->Used > 0 && ((char*)ptr) == (URCL_ArenaBlockData(block) + block->Last) && URCL_ArenaAlign(newSize) <= (block->Capacity - block->Last))
+	{
+		block->Used = block->Last + URCL_ArenaAlign(newSize);
+		return ptr;
+	}
+
+	if (newSize <= oldSize) return ptr;
+
+	void* result = URCL_ArenaAlloc(arena, newSize);
+	if (result != 0) URCL_memcpy(result, ptr, oldSize);
+	return result;
+}
+
+////description Moves every block owned by the source arena into the destination arena, leaving the source arena empty. Memory allocated from the source arena remains valid until the destination arena is freed.
+void URCL_ArenaAbsorb(URCL_Arena* destination, URCL_Arena* source)
+{
+	if (source->Blocks == 0) return;
+
+	if (destination->Blocks == 0)
+	{
+		destination->Blocks = source->Blocks;
+	}
+	else
+	{
+		URCL_ArenaBlock* first = source->Blocks;
+		while (first->Previous != 0) first = first->Previous;
+
+		first->Previous = destination->Blocks->Previous;
+		destination->Blocks->Previous = source->Blocks;
+	}
+
+	source->Blocks = 0;
+}
+
+////description Frees every block owned by the specified arena, releasing all memory allocated from it at once.
+void URCL_FreeArena(URCL_Arena* arena)
+{
+	while (arena->Blocks != 0)
+	{
+		URCL_ArenaBlock* previous = arena->Blocks->Previous;
+		URCL_free(arena->Blocks);
+		arena->Blocks = previous;
+	}
+}
+
+////description Frees all instructions in the specified array. Strings that are views into the parsed source are not freed.
+void URCL_FreeInstructions(URCL_InstructionInfo* instructions, size_t count)
 {
-	for (unsigned long i = 0; i < count; i++)
+	for (size_t i = 0; i < count; i++)
 	{
-		URCL_free(instructions[i].Operation);
+		if (!instructions[i].IsSourceView) URCL_free(instructions[i].Operation);
 		instructions[i].Operation = 0;
+		instructions[i].OperationLength = 0;
+		instructions[i].Opcode = URCL_Opcode_Unknown;
 
-		for (unsigned long j = 0; j < URCL_MaxOperands; j++)
+		for (size_t j = 0; j < URCL_MaxOperands; j++)
 		{
 			if (instructions[i].Operands[j].Type != URCL_OperandType_None)
 			{
-				URCL_free(instructions[i].Operands[j].StringValue);
+				if (!instructions[i].Operands[j].IsSourceView) URCL_free(instructions[i].Operands[j].StringValue);
 				instructions[i].Operands[j].StringValue = 0;
+				instructions[i].Operands[j].StringLength = 0;
 				instructions[i].Operands[j].ImmediateValue = 0;
 				instructions[i].Operands[j].Type = URCL_OperandType_None;
 			}
@@ -121,10 +514,352 @@ void URCL_FreeInstructions(URCL_InstructionInfo* instructions, unsigned long cou
 	}
 }
 
-////description Frees all labels in the specified array.
-void URCL_FreeLabels(URCL_LabelInfo* labels, unsigned long count)
+////description Frees all labels in the specified array. Names that are views into the parsed source are not freed.
+void URCL_FreeLabels(URCL_LabelInfo* labels, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!labels[i].IsSourceView) URCL_free(labels[i].Name);
+	}
+}
+
+////description Represents a constant defined with @DEFINE.
+typedef struct URCL_Define
+{
+	////class URCL_Define
+	////description The name of the constant without the macro prefix, or null if the entry is empty.
+	URCL_Char* Name;
+	////class URCL_Define
+	////description The number of characters in the name.
+	size_t NameLength;
+	////class URCL_Define
+	////description The hash of the name.
+	unsigned long long Hash;
+	////class URCL_Define
+	////description The operand that the constant expands to. Its string is owned by the table.
+	URCL_OperandInfo Value;
+} URCL_Define;
+
+////description Represents a hash table of constants defined with @DEFINE. A table can be shared by several parses, so constants defined by one source can be used by the sources parsed after it.
+typedef struct URCL_Defines
+{
+	////class URCL_Defines
+	////description The entries of the table, or null if the table is empty.
+	URCL_Define* Entries;
+	////class URCL_Defines
+	////description The number of entries in the table, which is always a power of two.
+	size_t Capacity;
+	////class URCL_Defines
+	////description The number of constants in the table.
+	size_t Count;
+} URCL_Defines;
+
+////description Initializes an empty table of constants.
+void URCL_InitDefines(URCL_Defines* defines)
+{
+	defines->Entries = 0;
+	defines->Capacity = 0;
+	defines->Count = 0;
+}
+
+////description Frees every constant in the specified table, leaving it empty.
+void URCL_FreeDefines(URCL_Defines* defines)
+{
+	for (size_t i = 0; i < defines->Capacity; i++)
+	{
+		if (defines->Entries[i].Name == 0) continue;
+		URCL_free(defines->Entries[i].Name);
+		URCL_free(defines->Entries[i].Value.StringValue);
+	}
+
+	URCL_free(defines->Entries);
+	URCL_InitDefines(defines);
+}
+
+unsigned long long URCL_GetDefineHash(const URCL_Char* name, size_t nameLength)
+{
+	unsigned long long hash = 0xCBF29CE484222325ULL;
+	for (size_t i = 0; i < nameLength; i++) hash = (hash ^ name[i]) * 0x100000001B3ULL;
+	return hash;
+}
+
+URCL_Define* URCL_FindDefineEntry(URCL_Define* entries, size_t capacity, const URCL_Char* name, size_t nameLength, unsigned long long hash)
+{
+	size_t mask = capacity - 1;
+	for (size_t i = (size_t)hash & mask; ; i = (i + 1) & mask)
+	{
+		URCL_Define* entry = entries + i;
+		if (entry->Name == 0) return entry;
+		if ((entry->Hash == hash) && (entry->NameLength == nameLength))
+		{
+			size_t j = 0;
+			for (; (j < nameLength) && (entry->Name[j] == name[j]); j++);
+			if (j == nameLength) return entry;
+		}
+	}
+}
+
+////description Returns the operand that the constant with the specified name expands to, or null if the constant is not defined. The name does not include the macro prefix.
+const URCL_OperandInfo* URCL_FindDefine(const URCL_Defines* defines, const URCL_Char* name, size_t nameLength)
+{
+	if (defines->Count == 0) return 0;
+
+	URCL_Define* entry = URCL_FindDefineEntry(defines->Entries, defines->Capacity, name, nameLength, URCL_GetDefineHash(name, nameLength));
+	return entry->Name != 0 ? &(entry->Value) : 0;
+}
+
+////description Defines or redefines the constant with the specified name as a copy of the specified operand. The name does not include the macro prefix. Returns true if successful or false if out of memory.
+bool URCL_TrySetDefine(URCL_Defines* defines, const URCL_Char* name, size_t nameLength, const URCL_OperandInfo* value)
+{
+	if (((defines->Count + 1) * 4) > (defines->Capacity * 3))
+	{
+		size_t capacity = defines->Capacity > 0 ? defines->Capacity * 2 : 64;
+		URCL_Define* entries = (URCL_Define*)URCL_malloc(capacity * sizeof(URCL_Define));
+		if (entries == 0) return false;
+
+		for (size_t i = 0; i < capacity; i++) entries[i].Name = 0;
+		for (size_t i = 0; i < defines->Capacity; i++)
+		{
+			URCL_Define* entry = defines->Entries + i;
+			if (entry->Name != 0) *URCL_FindDefineEntry(entries, capacity, entry->Name, entry->NameLength, entry->Hash) = *entry;
+		}
+
+		URCL_free(defines->Entries);
+		defines->Entries = entries;
+		defines->Capacity = capacity;
+	}
+
+	URCL_Char* stringValue = 0;
+	if (value->StringValue != 0)
+	{
+		stringValue = (URCL_Char*)URCL_malloc((value->StringLength + 1) * sizeof(URCL_Char));
+		if (stringValue == 0) return false;
+		URCL_memcpy(stringValue, value->StringValue, value->StringLength * sizeof(URCL_Char));
+		stringValue[value->StringLength] = 0;
+	}
+
+	unsigned long long hash = URCL_GetDefineHash(name, nameLength);
+	URCL_Define* entry = URCL_FindDefineEntry(defines->Entries, defines->Capacity, name, nameLength, hash);
+
+	if (entry->Name == 0)
+	{
+		entry->Name = (URCL_Char*)URCL_malloc((nameLength + 1) * sizeof(URCL_Char));
+		if (entry->Name == 0)
+		{
+			URCL_free(stringValue);
+			return false;
+		}
+
+		URCL_memcpy(entry->Name, name, nameLength * sizeof(URCL_Char));
+		entry->Name[nameLength] = 0;
+		entry->NameLength = nameLength;
+		entry->Hash = hash;
+		defines->Count++;
+	}
+	else
+	{
+		URCL_free(entry->Value.StringValue);
+	}
+
+	entry->Value = *value;
+	entry->Value.StringValue = stringValue;
+	entry->Value.IsSourceView = false;
+	return true;
+}
+
+////description Represents the offset of the start of each line of a source.
+typedef struct URCL_LineIndex
+{
+	////class URCL_LineIndex
+	////description The offset of the first character of each line, in ascending order. The first line starts at offset 0.
+	size_t* LineStarts;
+	////class URCL_LineIndex
+	////description The number of lines, which is one more than the number of line breaks.
+	size_t LineCount;
+} URCL_LineIndex;
+
+////description The number of instructions between the checkpoints of a source map.
+#define URCL_SourceMapStride 32
+
+////description Represents the position in the encoded data of a source map where an instruction starts.
+typedef struct URCL_SourceMapCheckpoint
+{
+	////class URCL_SourceMapCheckpoint
+	////description The offset of the instruction in the encoded data.
+	size_t Offset;
+	////class URCL_SourceMapCheckpoint
+	////description The line of the previous instruction, or 0 for the first instruction.
+	size_t Line;
+} URCL_SourceMapCheckpoint;
+
+////description Represents the line and column of each instruction parsed from a source, along with the line index of that source. Each position is stored as the line delta from the previous instruction and the column, both as variable-length numbers. A checkpoint is stored every URCL_SourceMapStride instructions, so finding a position decodes only a few entries.
+typedef struct URCL_SourceMap
+{
+	////class URCL_SourceMap
+	////description The line index of the parsed source.
+	URCL_LineIndex Lines;
+	////class URCL_SourceMap
+	////description The number of instructions in the map.
+	size_t Count;
+	////class URCL_SourceMap
+	////description The encoded positions of the instructions.
+	unsigned char* Data;
+	////class URCL_SourceMap
+	////description The number of bytes of encoded positions.
+	size_t DataLength;
+	////class URCL_SourceMap
+	////description The number of bytes allocated for encoded positions.
+	size_t DataCapacity;
+	////class URCL_SourceMap
+	////description The checkpoint of every URCL_SourceMapStride-th instruction.
+	URCL_SourceMapCheckpoint* Checkpoints;
+	////class URCL_SourceMap
+	////description The number of checkpoints allocated.
+	size_t CheckpointCapacity;
+	////class URCL_SourceMap
+	////description The line of the last instruction in the map.
+	size_t LastLine;
+} URCL_SourceMap;
+
+////description Initializes an empty line index.
+void URCL_InitLineIndex(URCL_LineIndex* lines)
+{
+	lines->LineStarts = 0;
+	lines->LineCount = 0;
+}
+
+////description Frees the specified line index, leaving it empty.
+void URCL_FreeLineIndex(URCL_LineIndex* lines)
+{
+	URCL_free(lines->LineStarts);
+	URCL_InitLineIndex(lines);
+}
+
+////description Returns the zero-based line that contains the specified offset of the source of the specified line index.
+size_t URCL_GetLineOfOffset(const URCL_LineIndex* lines, size_t offset)
+{
+	size_t low = 0;
+	size_t high = lines->LineCount;
+
+	while ((high - low) > 1)
+	{
+		size_t middle = low + ((high - low) / 2);
+		if (lines->LineStarts[middle] <= offset) low = middle;
+		else high = middle;
+	}
+
+	return low;
+}
+
+////description Gets the zero-based line and column of the specified offset of the source of the specified line index. Columns are counted in characters.
+void URCL_GetLineColumn(const URCL_LineIndex* lines, size_t offset, size_t* line, size_t* column)
+{
+	*line = URCL_GetLineOfOffset(lines, offset);
+	*column = lines->LineCount > 0 ? offset - lines->LineStarts[*line] : offset;
+}
+
+////description Initializes an empty source map. A parser with a source map fills it each time it parses a source.
+void URCL_InitSourceMap(URCL_SourceMap* map)
+{
+	URCL_InitLineIndex(&(map->Lines));
+	map->Count = 0;
+	map->Data = 0;
+	map->DataLength = 0;
+	map->DataCapacity = 0;
+	map->Checkpoints = 0;
+	map->CheckpointCapacity = 0;
+	map->LastLine = 0;
+}
+
+////description Frees the specified source map, leaving it empty.
+void URCL_FreeSourceMap(URCL_SourceMap* map)
+{
+	URCL_FreeLineIndex(&(map->Lines));
+	URCL_free(map->Data);
+	URCL_free(map->Checkpoints);
+	URCL_InitSourceMap(map);
+}
+
+size_t URCL_ReadSourceMapNumber(const unsigned char* data, size_t* offset)
+{
+	size_t result = 0;
+	for (size_t shift = 0; ; shift += 7)
+	{
+		unsigned char value = data[(*offset)++];
+		result |= (size_t)(value & 0x7F) << shift;
+		if ((value & 0x80) == 0) return result;
+	}
+}
+
+////description Gets the zero-based line and column of the instruction with the specified index in the specified source map. Returns true if successful or false if the map has no such instruction.
+bool URCL_TryGetSourceMapPosition(const URCL_SourceMap* map, size_t index, size_t* line, size_t* column)
+{
+	if (index >= map->Count) return false;
+
+	size_t checkpoint = index / URCL_SourceMapStride;
+	size_t offset = map->Checkpoints[checkpoint].Offset;
+	*line = map->Checkpoints[checkpoint].Line;
+
+	for (size_t i = checkpoint * URCL_SourceMapStride; i <= index; i++)
+	{
+		*line += URCL_ReadSourceMapNumber(map->Data, &offset);
+		*column = URCL_ReadSourceMapNumber(map->Data, &offset);
+	}
+
+	return true;
+}
+
+////description Represents a range of words in a data segment.
+typedef struct URCL_DataRange
+{
+	////class URCL_DataRange
+	////description The index of the first word of the range.
+	size_t Start;
+	////class URCL_DataRange
+	////description The number of words in the range.
+	size_t Count;
+} URCL_DataRange;
+
+////description Represents the words of DW lines stored contiguously instead of as one instruction per word. Each run of DW words becomes a single instruction whose operand refers to a range of the segment. Label addresses still count every word of a range, so they are the same as when the words are parsed as separate instructions.
+typedef struct URCL_DataSegment
+{
+	////class URCL_DataSegment
+	////description The words of every range, in source order.
+	unsigned long long* Words;
+	////class URCL_DataSegment
+	////description The number of words in the segment.
+	size_t WordCount;
+	////class URCL_DataSegment
+	////description The number of words allocated.
+	size_t WordCapacity;
+	////class URCL_DataSegment
+	////description The ranges referred to by the operands of data instructions.
+	URCL_DataRange* Ranges;
+	////class URCL_DataSegment
+	////description The number of ranges in the segment.
+	size_t RangeCount;
+	////class URCL_DataSegment
+	////description The number of ranges allocated.
+	size_t RangeCapacity;
+} URCL_DataSegment;
+
+////description Initializes an empty data segment. A parser with a data segment fills it each time it parses a source.
+void URCL_InitDataSegment(URCL_DataSegment* segment)
+{
+	segment->Words = 0;
+	segment->WordCount = 0;
+	segment->WordCapacity = 0;
+	segment->Ranges = 0;
+	segment->RangeCount = 0;
+	segment->RangeCapacity = 0;
+}
+
+////description Frees the specified data segment, leaving it empty.
+void URCL_FreeDataSegment(URCL_DataSegment* segment)
 {
-	for (unsigned long i = 0; i < count; i++) URCL_free(labels[i].Name);
+	URCL_free(segment->Words);
+	URCL_free(segment->Ranges);
+	URCL_InitDataSegment(segment);
 }
 
 ////description Specifies the stack pointer register.
@@ -133,67 +868,121 @@ void URCL_FreeLabels(URCL_LabelInfo* labels, unsigned long count)
 #define URCL_Register_ProgramCounter 1
 
 ////description The allowed prefix characters for instructions.
-const URCL_Char* URCL_Prefixes_Instruction = u"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+const URCL_Char* URCL_Prefixes_Instruction = URCL_Text("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
 ////description The allowed prefix characters for macros.
-const URCL_Char* URCL_Prefixes_Macro = u"@";
+const URCL_Char* URCL_Prefixes_Macro = URCL_Text("@");
 ////description The allowed prefix characters for labels.
-const URCL_Char* URCL_Prefixes_Label = u".";
+const URCL_Char* URCL_Prefixes_Label = URCL_Text(".");
 ////description The allowed prefix characters for ports.
-const URCL_Char* URCL_Prefixes_Port = u"%";
+const URCL_Char* URCL_Prefixes_Port = URCL_Text("%");
 ////description The allowed prefix characters for immediates.
-const URCL_Char* URCL_Prefixes_Immediate = u"0123456789";
+const URCL_Char* URCL_Prefixes_Immediate = URCL_Text("0123456789");
 ////description The allowed prefix characters for relative addresses.
-const URCL_Char* URCL_Prefixes_Relative = u"~";
+const URCL_Char* URCL_Prefixes_Relative = URCL_Text("~");
 ////description The allowed prefix characters for addresses.
-const URCL_Char* URCL_Prefixes_Memory = u"Mm#";
+const URCL_Char* URCL_Prefixes_Memory = URCL_Text("Mm#");
 ////description The allowed prefix characters for registers.
-const URCL_Char* URCL_Prefixes_Register = u"Rr$";
+const URCL_Char* URCL_Prefixes_Register = URCL_Text("Rr$");
 
 ////description The name of the BITS header.
-const URCL_Char* URCL_Header_Bits = u"BITS";
+const URCL_Char* URCL_Header_Bits = URCL_Text("BITS");
 ////description The name of the MINREG header.
-const URCL_Char* URCL_Header_MinimumRegisters = u"MINREG";
+const URCL_Char* URCL_Header_MinimumRegisters = URCL_Text("MINREG");
 ////description The name of the MINHEAP header.
-const URCL_Char* URCL_Header_MinimumHeap = u"MINHEAP";
+const URCL_Char* URCL_Header_MinimumHeap = URCL_Text("MINHEAP");
 ////description The name of the MINSTACK header.
-const URCL_Char* URCL_Header_MinimumStack = u"MINSTACK";
+const URCL_Char* URCL_Header_MinimumStack = URCL_Text("MINSTACK");
 ////description The name of the RUN header.
-const URCL_Char* URCL_Header_InstructionStorage = u"RUN";
+const URCL_Char* URCL_Header_InstructionStorage = URCL_Text("RUN");
+
+////description The canonical names of the opcodes, indexed by opcode.
+const URCL_Char* URCL_OpcodeNames[URCL_OpcodeCount] =
+{
+	0,
+	URCL_Text("ADD"), URCL_Text("RSH"), URCL_Text("LOD"), URCL_Text("STR"), URCL_Text("BGE"), URCL_Text("NOR"), URCL_Text("IMM"), URCL_Text("SUB"),
+	URCL_Text("JMP"), URCL_Text("MOV"), URCL_Text("NOP"), URCL_Text("LSH"), URCL_Text("INC"), URCL_Text("DEC"), URCL_Text("NEG"), URCL_Text("AND"),
+	URCL_Text("OR"), URCL_Text("NOT"), URCL_Text("XNOR"), URCL_Text("XOR"), URCL_Text("NAND"), URCL_Text("BRL"), URCL_Text("BRG"), URCL_Text("BRE"),
+	URCL_Text("BNE"), URCL_Text("BOD"), URCL_Text("BEV"), URCL_Text("BLE"), URCL_Text("BRZ"), URCL_Text("BNZ"), URCL_Text("BRN"), URCL_Text("BRP"),
+	URCL_Text("PSH"), URCL_Text("POP"), URCL_Text("CAL"), URCL_Text("RET"), URCL_Text("HLT"), URCL_Text("CPY"), URCL_Text("BRC"), URCL_Text("BNC"),
+	URCL_Text("MLT"), URCL_Text("DIV"), URCL_Text("MOD"), URCL_Text("BSR"), URCL_Text("BSL"), URCL_Text("SRS"), URCL_Text("BSS"), URCL_Text("SETE"),
+	URCL_Text("SETNE"), URCL_Text("SETG"), URCL_Text("SETL"), URCL_Text("SETGE"), URCL_Text("SETLE"), URCL_Text("SETC"), URCL_Text("SETNC"), URCL_Text("LLOD"),
+	URCL_Text("LSTR"), URCL_Text("SDIV"), URCL_Text("SBRL"), URCL_Text("SBRG"), URCL_Text("SBLE"), URCL_Text("SBGE"), URCL_Text("SSETL"), URCL_Text("SSETG"),
+	URCL_Text("SSETLE"), URCL_Text("SSETGE"), URCL_Text("ABS"), URCL_Text("UMLT"), URCL_Text("SUMLT"), URCL_Text("IN"), URCL_Text("OUT"), URCL_Text("DW"),
+	URCL_Text("BITS"), URCL_Text("MINREG"), URCL_Text("MINHEAP"), URCL_Text("MINSTACK"), URCL_Text("RUN")
+};
+
+////description The lengths of the canonical names of the opcodes, indexed by opcode.
+const unsigned char URCL_OpcodeNameLengths[URCL_OpcodeCount] =
+{
+	0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	3, 2, 3, 4, 3, 4, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	4, 5, 4, 4, 5, 5, 4, 5, 4, 4, 4, 4, 4, 4, 4, 5,
+	5, 6, 6, 3, 4, 5, 2, 3, 2, 4, 6, 7, 8, 3
+};
 
 ////description No error has occured.
-const URCL_Char* URCL_Error_NoError = u"No error message has been set.";
+const URCL_Char* URCL_Error_NoError = URCL_Text("No error message has been set.");
 ////description The program ran out of memory while parsing.
-const URCL_Char* URCL_Error_OutOfMemory = u"Out of memory.";
+const URCL_Char* URCL_Error_OutOfMemory = URCL_Text("Out of memory.");
 ////description An operand is missing a prefix that the parser recognizes.
-const URCL_Char* URCL_Error_MissingOperandPrefix = u"Missing valid operand prefix.";
+const URCL_Char* URCL_Error_MissingOperandPrefix = URCL_Text("Missing valid operand prefix.");
 ////description A character in a hexadecimal value was not within the range [0-9,A-F,a-f].
-const URCL_Char* URCL_Error_UnexpectedHexChar = u"Unexpected character in hexadecimal value.";
+const URCL_Char* URCL_Error_UnexpectedHexChar = URCL_Text("Unexpected character in hexadecimal value.");
 ////description A character in an octal value was not within the range [0-7].
-const URCL_Char* URCL_Error_UnexpectedOctChar = u"Unexpected character in octal value.";
+const URCL_Char* URCL_Error_UnexpectedOctChar = URCL_Text("Unexpected character in octal value.");
 ////description A character in a binary value was not within the range [0-1].
-const URCL_Char* URCL_Error_UnexpectedBinChar = u"Unexpected character in binary value.";
+const URCL_Char* URCL_Error_UnexpectedBinChar = URCL_Text("Unexpected character in binary value.");
 ////description A character in a decimal value was not within the range [0-9].
-const URCL_Char* URCL_Error_UnexpectedDecChar = u"Unexpected character in decimal value.";
+const URCL_Char* URCL_Error_UnexpectedDecChar = URCL_Text("Unexpected character in decimal value.");
 ////description An immediate is missing a prefix that the parser recognizes [0x,0o,0b].
-const URCL_Char* URCL_Error_UnknownImmTypePrefix = u"Unknown immediate type prefix.";
+const URCL_Char* URCL_Error_UnknownImmTypePrefix = URCL_Text("Unknown immediate type prefix.");
 ////description A relative address operand was missing a sub-prefix within the range [+,-,0-9].
-const URCL_Char* URCL_Error_UnexpectedRelativeChar = u"Unexpected character in relative value.";
+const URCL_Char* URCL_Error_UnexpectedRelativeChar = URCL_Text("Unexpected character in relative value.");
 ////description A relative address operand exceeds the machine word size.
-const URCL_Char* URCL_Error_RelativeValueTooLarge = u"Relative value is too large.";
+const URCL_Char* URCL_Error_RelativeValueTooLarge = URCL_Text("Relative value is too large.");
 ////description A relative address operand was malformed.
-const URCL_Char* URCL_Error_InvalidRelativeValue = u"Invalid relative value.";
+const URCL_Char* URCL_Error_InvalidRelativeValue = URCL_Text("Invalid relative value.");
 ////description A memory address operand was malformed.
-const URCL_Char* URCL_Error_InvalidMemoryAddress = u"Invalid memory address value.";
+const URCL_Char* URCL_Error_InvalidMemoryAddress = URCL_Text("Invalid memory address value.");
 ////description A register operand was malformed.
-const URCL_Char* URCL_Error_InvalidRegisterIndex = u"Invalid register index.";
+const URCL_Char* URCL_Error_InvalidRegisterIndex = URCL_Text("Invalid register index.");
 ////description A register operand was not a valid general-purpose register and did not match any special-purpose registers.
-const URCL_Char* URCL_Error_UnknownRegister = u"Unknown register.";
+const URCL_Char* URCL_Error_UnknownRegister = URCL_Text("Unknown register.");
 ////description A macro with the specified name was not defined by the consumer.
-const URCL_Char* URCL_Error_UnknownMacro = u"Unknown macro.";
+const URCL_Char* URCL_Error_UnknownMacro = URCL_Text("Unknown macro.");
 ////description An operand was expected but not found.
-const URCL_Char* URCL_Error_ExpectedOperand = u"Expected operand.";
+const URCL_Char* URCL_Error_ExpectedOperand = URCL_Text("Expected operand.");
 ////description An instruction name was expected but not found.
-const URCL_Char* URCL_Error_ExpectedOperation = u"Expected operation.";
+const URCL_Char* URCL_Error_ExpectedOperation = URCL_Text("Expected operation.");
+////description A source handler stopped the parser.
+const URCL_Char* URCL_Error_StoppedByHandler = URCL_Text("Parsing was stopped by a handler.");
+////description A source file could not be opened or read.
+const URCL_Char* URCL_Error_UnreadableFile = URCL_Text("The file could not be read.");
+////description A program image is invalid or does not match the source it was read for.
+const URCL_Char* URCL_Error_InvalidImage = URCL_Text("Invalid program image.");
+////description An edit is outside of the source it applies to.
+const URCL_Char* URCL_Error_InvalidEdit = URCL_Text("The edit is outside of the source.");
+////description A line could not be parsed as a label, a macro, or an instruction.
+const URCL_Char* URCL_Error_InvalidLine = URCL_Text("Invalid line.");
+////description A @DEFINE line is missing its name or value, or has more than one value.
+const URCL_Char* URCL_Error_InvalidDefine = URCL_Text("Invalid constant definition.");
+////description An immediate value does not fit in 64 bits, or an immediate, memory address, or relative operand of an instruction does not fit in the target bits of the parser. Relative offsets are checked as signed values.
+const URCL_Char* URCL_Error_ImmediateTooLarge = URCL_Text("Immediate value is too large.");
+////description A DW array is not closed with a bracket on the line where it starts.
+const URCL_Char* URCL_Error_ExpectedArrayEnd = URCL_Text("Expected ']' at the end of the array.");
+////description The parser has allocated the maximum number of bytes allowed by its limits.
+const URCL_Char* URCL_Error_AllocationLimit = URCL_Text("The allocation limit was exceeded.");
+////description A source has more instructions than the limits of the parser allow.
+const URCL_Char* URCL_Error_InstructionLimit = URCL_Text("The instruction limit was exceeded.");
+////description A source has more labels than the limits of the parser allow.
+const URCL_Char* URCL_Error_LabelLimit = URCL_Text("The label limit was exceeded.");
+////description A source has more headers than the limits of the parser allow.
+const URCL_Char* URCL_Error_HeaderLimit = URCL_Text("The header limit was exceeded.");
+////description Macros expand into other macros more deeply than the limits of the parser allow.
+const URCL_Char* URCL_Error_MacroDepthLimit = URCL_Text("The macro expansion depth limit was exceeded.");
+////description A token is longer than the limits of the parser allow.
+const URCL_Char* URCL_Error_TokenTooLong = URCL_Text("Token is too long.");
 
 ////description Represents an error that has occured in the parser.
 struct URCL_ErrorInfo
@@ -206,7 +995,7 @@ struct URCL_ErrorInfo
 	const URCL_Char* Position;
 	////class URCL_ErrorInfo
 	////description The length of the source region where the error occurred. May be 0 if the error has no relevant source region.
-	unsigned long Length;
+	size_t Length;
 	////class URCL_ErrorInfo
 	////description A message describing the error.
 	const URCL_Char* Message;
@@ -215,7 +1004,7 @@ struct URCL_ErrorInfo
 ////id URCL_Error
 ////type field
 ////description The last error reported by the parser.
-struct URCL_ErrorInfo URCL_Error = { false, 0, 0, u"No error message has been set." };
+struct URCL_ErrorInfo URCL_Error = { false, 0, 0, URCL_Text("No error message has been set.") };
 
 ////description Resets URCL_Error to its default state.
 void URCL_ResetError()
@@ -227,7 +1016,7 @@ void URCL_ResetError()
 }
 
 ////description Sets URCL_Error based on the specified message, position, and length.
-void URCL_SetError(const URCL_Char* message, const URCL_Char* position, unsigned long length)
+void URCL_SetError(const URCL_Char* message, const URCL_Char* position, size_t length)
 {
 	URCL_Error.HasError = true;
 	URCL_Error.Position = position;
@@ -241,90 +1030,477 @@ bool URCL_HasError()
 	return URCL_Error.HasError;
 }
 
-bool URCL_NoMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+////description Represents the resource limits of a parser, which stop a parse with an error instead of letting an untrusted source use unbounded memory or time. A limit of 0 means no limit.
+typedef struct URCL_ParserLimits
 {
-	unsigned long length = 0;
-	for (; name[length] != 0; length++);
+	////class URCL_ParserLimits
+	////description The maximum number of bytes the parser may allocate for parsed arrays, strings, constants, program columns, and the growth of its source map and data segment until its limits are set again. Freed bytes are not returned to the budget.
+	size_t MaxAllocatedBytes;
+	////class URCL_ParserLimits
+	////description The maximum number of instructions in a source.
+	size_t MaxInstructions;
+	////class URCL_ParserLimits
+	////description The maximum number of labels in a source.
+	size_t MaxLabels;
+	////class URCL_ParserLimits
+	////description The maximum number of headers in a source.
+	size_t MaxHeaders;
+	////class URCL_ParserLimits
+	////description The maximum number of macros that may be expanded inside each other, where a macro in the source has a depth of 1.
+	size_t MaxMacroDepth;
+	////class URCL_ParserLimits
+	////description The maximum length of a token in a source line, in characters.
+	size_t MaxTokenLength;
+} URCL_ParserLimits;
+
+////description Initializes the specified parser limits to no limits.
+void URCL_InitParserLimits(URCL_ParserLimits* limits)
+{
+	limits->MaxAllocatedBytes = 0;
+	limits->MaxInstructions = 0;
+	limits->MaxLabels = 0;
+	limits->MaxHeaders = 0;
+	limits->MaxMacroDepth = 0;
+	limits->MaxTokenLength = 0;
+}
 
-	URCL_SetError(URCL_Error_UnknownMacro, source, length);
+////description Represents the state of a parser, including its error state, macro handler, target bits, and allocator. Separate parsers share no mutable state, so each thread can parse with its own parser.
+typedef struct URCL_Parser
+{
+	////class URCL_Parser
+	////description The last error reported by the parser.
+	struct URCL_ErrorInfo Error;
+	////class URCL_Parser
+	////description The array that errors are collected into so that parsing can continue on the next line, or null if parsing stops at the first error.
+	struct URCL_ErrorInfo* Errors;
+	////class URCL_Parser
+	////description The number of errors collected into the error array.
+	size_t ErrorCount;
+	////class URCL_Parser
+	////description The number of errors the error array can hold. Parsing stops when it is full.
+	size_t MaxErrors;
+	////class URCL_Parser
+	////description The handler used to expand macros.
+	bool (*MacroHandler)(struct URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result);
+	////class URCL_Parser
+	////description The data passed to the macro handler with each call.
+	void* MacroHandlerData;
+	////class URCL_Parser
+	////description The handler that expands a macro operand directly into an operand, or null if macro operands are expanded by the macro handler.
+	bool (*MacroOperandHandler)(struct URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_OperandInfo* result);
+	////class URCL_Parser
+	////description The handler that expands a macro instruction directly into an instruction, or null if macro instructions are expanded by the macro handler.
+	bool (*MacroInstructionHandler)(struct URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result);
+	////class URCL_Parser
+	////description The data passed to the typed macro handlers with each call.
+	void* TypedMacroHandlerData;
+	////class URCL_Parser
+	////description The maximum number of bits per word.
+	unsigned long TargetBits;
+	////class URCL_Parser
+	////description The arena that parsed arrays and strings are allocated from, or null if they are allocated with URCL_malloc.
+	URCL_Arena* Arena;
+	////class URCL_Parser
+	////description True if parsed strings are views into the source instead of owned copies.
+	bool SourceViews;
+	////class URCL_Parser
+	////description The directory where parse results are cached by the content of their source, or null if parse results are not cached. Caching requires URCL_Files and is skipped for custom macro handlers, error lists, source maps, data segments, resource limits other than the macro depth limit, and constant tables unless the table is empty and the source defines no constants.
+	const char* CacheDirectory;
+	////class URCL_Parser
+	////description The table that @DEFINE lines add constants to and macro operands are looked up in before the macro handlers, or null if @DEFINE is not supported.
+	URCL_Defines* Defines;
+	////class URCL_Parser
+	////description The source map that the position of each parsed instruction is added to, or null if no source map is built. The map is cleared at the start of each parsed source.
+	URCL_SourceMap* SourceMap;
+	////class URCL_Parser
+	////description The data segment that the immediate words of DW lines are stored in, or null if every DW word is parsed as a separate instruction. The segment is cleared at the start of each parsed source. Documents and skims do not use the data segment.
+	URCL_DataSegment* DataSegment;
+	////class URCL_Parser
+	////description The target bits that the cached values of the basic macros were computed for, or 0 if they have not been computed.
+	unsigned long MacroValueBits;
+	////class URCL_Parser
+	////description The cached values of the basic macros, in the order of URCL_BasicMacroNames.
+	unsigned long long MacroValues[7];
+	////class URCL_Parser
+	////description The resource limits of the parser. Hitting a limit stops the parse with an error that is never collected into the error list, and every partial result is released.
+	URCL_ParserLimits Limits;
+	////class URCL_Parser
+	////description The number of bytes charged against the allocation limit since the limits were set.
+	size_t AllocatedBytes;
+	////class URCL_Parser
+	////description The number of macros currently being expanded inside each other.
+	size_t MacroDepth;
+} URCL_Parser;
+
+////description Resets the error of the specified parser to its default state.
+void URCL_ResetParserError(URCL_Parser* parser)
+{
+	parser->Error.HasError = false;
+	parser->Error.Position = 0;
+	parser->Error.Length = 0;
+	parser->Error.Message = URCL_Error_NoError;
+}
 
-	return false;
+////description Sets the error of the specified parser based on the specified message, position, and length.
+void URCL_SetParserError(URCL_Parser* parser, const URCL_Char* message, const URCL_Char* position, size_t length)
+{
+	parser->Error.HasError = true;
+	parser->Error.Position = position;
+	parser->Error.Length = length;
+	parser->Error.Message = message;
 }
 
-void* URCL_memcpy(void* dest, const void* src, size_t n)
+////description Returns true if the error of the specified parser is set or false otherwise.
+bool URCL_ParserHasError(URCL_Parser* parser)
 {
-	for (size_t i = 0; i < n; i++) ((char*)dest)[i] = ((char*)src)[i];
-	return dest;
+	return parser->Error.HasError;
 }
 
-URCL_Char* URCL_Substring(const URCL_Char* value, unsigned long index, unsigned long length)
+bool URCL_TryChargeAllocation(URCL_Parser* parser, size_t size)
 {
-	URCL_Char* result = (URCL_Char*)URCL_malloc((length + 1) * sizeof(URCL_Char));
-	
-	if (result == 0)
+	size_t limit = parser->Limits.MaxAllocatedBytes;
+	if ((limit == 0) || (size <= (limit - parser->AllocatedBytes)))
 	{
-		URCL_SetError(URCL_Error_OutOfMemory, value, 0);
-		return 0;
+		parser->AllocatedBytes += size;
+		return true;
 	}
 
-	URCL_memcpy(result, value + index, length * sizeof(URCL_Char));
-	result[length] = 0;
-
-	return result;
+	parser->AllocatedBytes = limit;
+	URCL_SetParserError(parser, URCL_Error_AllocationLimit, 0, 0);
+	return false;
 }
 
-unsigned long URCL_TargetBits = 64;
-
-URCL_Char* URCL_ValueToString(unsigned long long value)
+void URCL_SetOutOfMemoryError(URCL_Parser* parser, const URCL_Char* position)
 {
-	URCL_Char* result = (URCL_Char*)URCL_malloc(sizeof(URCL_Char) * (URCL_TargetBits + 3));
-	
-	if (result == 0)
-	{
-		URCL_SetError(URCL_Error_OutOfMemory, 0, 0);
-		return 0;
-	}
-	
-	result[0] = '0';
-	result[1] = 'b';
-
-	for (unsigned long offset = URCL_TargetBits, i = 2; offset > 0; offset--, i++)
-	{
-		result[i] = ((value >> (offset - 1)) & 1) ? '1' : '0';
-	}
+	if (parser->Error.Message == URCL_Error_AllocationLimit) URCL_SetParserError(parser, URCL_Error_AllocationLimit, position, 0);
+	else URCL_SetParserError(parser, URCL_Error_OutOfMemory, position, 0);
+}
 
-	result[URCL_TargetBits + 2] = 0;
-	
-	return result;
+bool URCL_IsParserLimitError(URCL_Parser* parser)
+{
+	const URCL_Char* message = parser->Error.Message;
+	return (message == URCL_Error_AllocationLimit) || (message == URCL_Error_InstructionLimit) || (message == URCL_Error_LabelLimit) || (message == URCL_Error_HeaderLimit) || (message == URCL_Error_MacroDepthLimit) || (message == URCL_Error_TokenTooLong);
 }
 
-bool URCL_BasicMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result);
+bool URCL_TryCheckParserLimit(URCL_Parser* parser, size_t count, size_t limit, const URCL_Char* message, const URCL_Char* position, size_t length)
+{
+	if ((limit == 0) || (count <= limit)) return true;
 
-bool (*URCL_MacroHandler)(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result) = URCL_BasicMacroHandler;
-void* URCL_MacroHandlerData = 0;
+	URCL_SetParserError(parser, message, position, length);
+	return false;
+}
 
-////description Disables all URCL macros.
-void URCL_ClearMacroHandler()
+bool URCL_HasParserCountLimits(URCL_Parser* parser)
 {
-	URCL_MacroHandler = URCL_NoMacroHandler;
-	URCL_MacroHandlerData = 0;
+	return (parser->Limits.MaxAllocatedBytes != 0) || (parser->Limits.MaxInstructions != 0) || (parser->Limits.MaxLabels != 0) || (parser->Limits.MaxHeaders != 0);
 }
 
-////description Enables macro handling with the specified handler. The data parameter will be passed to the handler with each call.
-void URCL_SetMacroHandler(bool (*getMacroValue)(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result), void* data)
+void* URCL_Allocate(URCL_Parser* parser, size_t size)
 {
-	URCL_MacroHandler = getMacroValue;
-	URCL_MacroHandlerData = data;
+	if (!URCL_TryChargeAllocation(parser, size)) return 0;
+	if (parser->Arena != 0) return URCL_ArenaAlloc(parser->Arena, size);
+	else return URCL_malloc(size);
 }
 
-////description Enables basic macro handling. [@MAX,@SMAX,@MSB,@SMSB,@LHALF,@UHALF,@BITS]
-void URCL_UseBasicMacroHandler()
+void* URCL_Reallocate(URCL_Parser* parser, void* ptr, size_t oldSize, size_t newSize)
 {
-	URCL_SetMacroHandler(URCL_BasicMacroHandler, 0);
+	if ((newSize > oldSize) && !URCL_TryChargeAllocation(parser, newSize - oldSize)) return 0;
+	if (parser->Arena != 0) return URCL_ArenaRealloc(parser->Arena, ptr, oldSize, newSize);
+	else return URCL_realloc(ptr, newSize);
 }
 
-////description Sets the maximum number of bits per word. Returns true if the number of bits is valid or false if the number of bits exceeds the consumer system's maximum bits per word.
-bool URCL_SetTargetBits(unsigned long bits)
+void URCL_Release(URCL_Parser* parser, void* ptr)
+{
+	if (parser->Arena == 0) URCL_free(ptr);
+}
+
+bool URCL_TryReserveParserArray(URCL_Parser* parser, void** items, size_t* capacity, size_t count, size_t itemSize)
+{
+	if ((*items != 0) && (count <= *capacity)) return true;
+
+	size_t newCapacity = URCL_GetReservedCapacity(*capacity, count, itemSize);
+	if (newCapacity == 0) return false;
+
+	size_t oldCapacity = (*items != 0) ? *capacity : 0;
+	return URCL_TryChargeAllocation(parser, (newCapacity - oldCapacity) * itemSize) && URCL_TryReserveArray(items, capacity, count, itemSize);
+}
+
+void URCL_ReleaseInstructions(URCL_Parser* parser, URCL_InstructionInfo* instructions, size_t count)
+{
+	if (parser->Arena == 0) URCL_FreeInstructions(instructions, count);
+}
+
+void URCL_ReleaseLabels(URCL_Parser* parser, URCL_LabelInfo* labels, size_t count)
+{
+	if (parser->Arena == 0) URCL_FreeLabels(labels, count);
+}
+
+bool URCL_NoMacroHandlerEx(URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+{
+	size_t length = 0;
+	for (; name[length] != 0; length++);
+
+	URCL_SetParserError(parser, URCL_Error_UnknownMacro, source, length);
+
+	return false;
+}
+
+URCL_Char* URCL_Substring(URCL_Parser* parser, const URCL_Char* value, size_t index, size_t length)
+{
+	URCL_Char* result = (URCL_Char*)URCL_Allocate(parser, (length + 1) * sizeof(URCL_Char));
+	
+	if (result == 0)
+	{
+		URCL_SetOutOfMemoryError(parser, value);
+		return 0;
+	}
+
+	URCL_memcpy(result, value + index, length * sizeof(URCL_Char));
+	result[length] = 0;
+
+	return result;
+}
+
+URCL_Char* URCL_GetTokenString(URCL_Parser* parser, const URCL_Char* value, size_t length)
+{
+	if (parser->SourceViews) return (URCL_Char*)value;
+	else return URCL_Substring(parser, value, 0, length);
+}
+
+void URCL_FreeTokenString(URCL_Parser* parser, URCL_Char* value)
+{
+	if (!parser->SourceViews) URCL_Release(parser, value);
+}
+
+bool URCL_TryOwnOperandString(URCL_Parser* parser, URCL_OperandInfo* operand)
+{
+	if (!operand->IsSourceView) return true;
+
+	operand->IsSourceView = false;
+	if (operand->StringValue == 0) return true;
+
+	operand->StringValue = URCL_Substring(parser, operand->StringValue, 0, operand->StringLength);
+	return operand->StringValue != 0;
+}
+
+bool URCL_TryOwnInstructionStrings(URCL_Parser* parser, URCL_InstructionInfo* instruction)
+{
+	bool success = true;
+
+	if (instruction->IsSourceView && (instruction->Opcode == URCL_Opcode_Unknown))
+	{
+		instruction->IsSourceView = false;
+		instruction->Operation = URCL_Substring(parser, instruction->Operation, 0, instruction->OperationLength);
+		success = instruction->Operation != 0;
+	}
+
+	for (size_t i = 0; i < URCL_MaxOperands; i++)
+	{
+		if (success)
+		{
+			success = URCL_TryOwnOperandString(parser, &(instruction->Operands[i]));
+		}
+		else if (instruction->Operands[i].IsSourceView)
+		{
+			instruction->Operands[i].IsSourceView = false;
+			instruction->Operands[i].StringValue = 0;
+		}
+	}
+
+	return success;
+}
+
+URCL_Char* URCL_ValueToString(URCL_Parser* parser, unsigned long long value)
+{
+	URCL_Char* result = (URCL_Char*)URCL_Allocate(parser, sizeof(URCL_Char) * (parser->TargetBits + 3));
+	
+	if (result == 0)
+	{
+		URCL_SetOutOfMemoryError(parser, 0);
+		return 0;
+	}
+	
+	result[0] = '0';
+	result[1] = 'b';
+
+	for (size_t offset = parser->TargetBits, i = 2; offset > 0; offset--, i++)
+	{
+		result[i] = ((value >> (offset - 1)) & 1) ? '1' : '0';
+	}
+
+	result[parser->TargetBits + 2] = 0;
+	
+	return result;
+}
+
+bool URCL_BasicMacroHandlerEx(URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result);
+
+////description Initializes the specified parser with basic macro handling, 64 target bits, no arena, and owned strings.
+void URCL_InitParser(URCL_Parser* parser)
+{
+	URCL_ResetParserError(parser);
+	parser->Errors = 0;
+	parser->ErrorCount = 0;
+	parser->MaxErrors = 0;
+	parser->MacroHandler = URCL_BasicMacroHandlerEx;
+	parser->MacroHandlerData = 0;
+	parser->MacroOperandHandler = 0;
+	parser->MacroInstructionHandler = 0;
+	parser->TypedMacroHandlerData = 0;
+	parser->TargetBits = 64;
+	parser->Arena = 0;
+	parser->SourceViews = false;
+	parser->CacheDirectory = 0;
+	parser->Defines = 0;
+	parser->SourceMap = 0;
+	parser->DataSegment = 0;
+	parser->MacroValueBits = 0;
+	URCL_InitParserLimits(&(parser->Limits));
+	parser->AllocatedBytes = 0;
+	parser->MacroDepth = 0;
+}
+
+////description Sets the resource limits of the specified parser and resets the number of bytes charged against its allocation limit.
+void URCL_SetParserLimits(URCL_Parser* parser, const URCL_ParserLimits* limits)
+{
+	parser->Limits = *limits;
+	parser->AllocatedBytes = 0;
+}
+
+////description Makes the specified parser collect errors into the specified array of the specified size instead of stopping at the first error, or stop at the first error again if the array is null. A line with an error is skipped and parsing continues on the next line, so a parse can succeed with partial results and collected errors. Parsing fails with the last collected error once the array is full. Errors from later parses are appended until the error list is set again.
+void URCL_SetParserErrorList(URCL_Parser* parser, struct URCL_ErrorInfo* errors, size_t maxErrors)
+{
+	parser->Errors = errors;
+	parser->ErrorCount = 0;
+	parser->MaxErrors = errors != 0 ? maxErrors : 0;
+}
+
+bool URCL_TryCollectParserError(URCL_Parser* parser)
+{
+	if ((parser->Errors == 0) || (parser->Error.Message == URCL_Error_OutOfMemory) || URCL_IsParserLimitError(parser) || (parser->ErrorCount >= parser->MaxErrors)) return false;
+
+	parser->Errors[parser->ErrorCount] = parser->Error;
+	parser->ErrorCount++;
+	if (parser->ErrorCount == parser->MaxErrors) return false;
+
+	URCL_ResetParserError(parser);
+	return true;
+}
+
+////description Disables all URCL macros for the specified parser.
+void URCL_ClearParserMacroHandler(URCL_Parser* parser)
+{
+	parser->MacroHandler = URCL_NoMacroHandlerEx;
+	parser->MacroHandlerData = 0;
+	parser->MacroOperandHandler = 0;
+	parser->MacroInstructionHandler = 0;
+	parser->TypedMacroHandlerData = 0;
+}
+
+////description Enables macro handling for the specified parser with the specified handler. The data parameter will be passed to the handler with each call. The result string must be allocated with URCL_malloc, since the parser frees it with URCL_free once it has been parsed and copied. The handler must report errors with URCL_SetParserError.
+void URCL_SetParserMacroHandler(URCL_Parser* parser, bool (*getMacroValue)(URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result), void* data)
+{
+	parser->MacroHandler = getMacroValue;
+	parser->MacroHandlerData = data;
+	parser->MacroOperandHandler = 0;
+	parser->MacroInstructionHandler = 0;
+	parser->TypedMacroHandlerData = 0;
+}
+
+////description Enables typed macro handling for the specified parser. Macro operands are passed to getOperand and macro instructions to getInstruction, which fill in the result directly instead of returning a string to be parsed again. Either handler may be null to keep expanding that kind of macro with the macro handler. The name is the macro token in the source and is not null-terminated. The parser copies every string in the result, so the handler may point them at its own storage. The handlers must report errors with URCL_SetParserError.
+void URCL_SetParserTypedMacroHandler(URCL_Parser* parser, bool (*getOperand)(URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_OperandInfo* result), bool (*getInstruction)(URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result), void* data)
+{
+	parser->MacroOperandHandler = getOperand;
+	parser->MacroInstructionHandler = getInstruction;
+	parser->TypedMacroHandlerData = data;
+}
+
+////description Sets the maximum number of bits per word for the specified parser. Returns true if the number of bits is valid or false if the number of bits exceeds the consumer system's maximum bits per word.
+bool URCL_SetParserTargetBits(URCL_Parser* parser, unsigned long bits)
+{
+	if ((bits / 8) > sizeof(unsigned long long))
+	{
+		return false;
+	}
+	else
+	{
+		parser->TargetBits = bits;
+		return true;
+	}
+}
+
+bool URCL_NoMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+{
+	size_t length = 0;
+	for (; name[length] != 0; length++);
+
+	URCL_SetError(URCL_Error_UnknownMacro, source, length);
+
+	return false;
+}
+
+bool URCL_SourceViewsEnabled = false;
+
+////description Sets whether parsed strings are views into the source instead of owned copies. If enabled, the source must outlive the parsed instructions and labels, and parsed strings are not null-terminated.
+void URCL_SetSourceViews(bool enabled)
+{
+	URCL_SourceViewsEnabled = enabled;
+}
+
+const char* URCL_CacheDirectory = 0;
+
+////description Sets the directory where parse results are cached by the content of their source, or disables caching if the directory is null. The directory must already exist and the path must outlive parsing.
+void URCL_SetCacheDirectory(const char* directory)
+{
+	URCL_CacheDirectory = directory;
+}
+
+unsigned long URCL_TargetBits = 64;
+
+bool URCL_BasicMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result);
+
+bool (*URCL_MacroHandler)(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result) = URCL_BasicMacroHandler;
+void* URCL_MacroHandlerData = 0;
+bool (*URCL_MacroOperandHandler)(void* data, const URCL_Char* name, size_t nameLength, URCL_OperandInfo* result) = 0;
+bool (*URCL_MacroInstructionHandler)(void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result) = 0;
+void* URCL_TypedMacroHandlerData = 0;
+
+////description Disables all URCL macros.
+void URCL_ClearMacroHandler()
+{
+	URCL_MacroHandler = URCL_NoMacroHandler;
+	URCL_MacroHandlerData = 0;
+	URCL_MacroOperandHandler = 0;
+	URCL_MacroInstructionHandler = 0;
+	URCL_TypedMacroHandlerData = 0;
+}
+
+////description Enables macro handling with the specified handler. The data parameter will be passed to the handler with each call.
+void URCL_SetMacroHandler(bool (*getMacroValue)(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result), void* data)
+{
+	URCL_MacroHandler = getMacroValue;
+	URCL_MacroHandlerData = data;
+	URCL_MacroOperandHandler = 0;
+	URCL_MacroInstructionHandler = 0;
+	URCL_TypedMacroHandlerData = 0;
+}
+
+////description Enables typed macro handling. Macro operands are passed to getOperand and macro instructions to getInstruction, which fill in the result directly instead of returning a string to be parsed again. Either handler may be null to keep expanding that kind of macro with the macro handler. The name is the macro token in the source and is not null-terminated. Every string in the result is copied, so the handler may point them at its own storage.
+void URCL_SetTypedMacroHandler(bool (*getOperand)(void* data, const URCL_Char* name, size_t nameLength, URCL_OperandInfo* result), bool (*getInstruction)(void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result), void* data)
+{
+	URCL_MacroOperandHandler = getOperand;
+	URCL_MacroInstructionHandler = getInstruction;
+	URCL_TypedMacroHandlerData = data;
+}
+
+////description Enables basic macro handling. [@MAX,@SMAX,@MSB,@SMSB,@LHALF,@UHALF,@BITS]
+void URCL_UseBasicMacroHandler()
+{
+	URCL_SetMacroHandler(URCL_BasicMacroHandler, 0);
+}
+
+////description Sets the maximum number of bits per word. Returns true if the number of bits is valid or false if the number of bits exceeds the consumer system's maximum bits per word.
+bool URCL_SetTargetBits(unsigned long bits)
 {
 	if ((bits / 8) > sizeof(unsigned long long))
 	{
@@ -337,6 +1513,59 @@ bool URCL_SetTargetBits(unsigned long bits)
 	}
 }
 
+bool URCL_InvokeGlobalMacroHandler(URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+{
+	URCL_Error = parser->Error;
+	bool returnValue = URCL_MacroHandler(data, name, source, result);
+	parser->Error = URCL_Error;
+	return returnValue;
+}
+
+bool URCL_InvokeGlobalMacroOperandHandler(URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_OperandInfo* result)
+{
+	URCL_Error = parser->Error;
+	bool returnValue = URCL_MacroOperandHandler(data, name, nameLength, result);
+	parser->Error = URCL_Error;
+	return returnValue;
+}
+
+bool URCL_InvokeGlobalMacroInstructionHandler(URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result)
+{
+	URCL_Error = parser->Error;
+	bool returnValue = URCL_MacroInstructionHandler(data, name, nameLength, result);
+	parser->Error = URCL_Error;
+	return returnValue;
+}
+
+////description Initializes the specified parser from the global error, macro handler, target bits, source view, and cache directory settings used by the functions that do not take a parser. Parsers initialized this way are only safe to use on multiple threads if the global macro handler is the basic handler or has been cleared and no typed macro handler is set.
+void URCL_InitParserFromGlobals(URCL_Parser* parser)
+{
+	URCL_InitParser(parser);
+	parser->Error = URCL_Error;
+	parser->TargetBits = URCL_TargetBits;
+	parser->SourceViews = URCL_SourceViewsEnabled;
+	parser->CacheDirectory = URCL_CacheDirectory;
+
+	if (URCL_MacroHandler == URCL_BasicMacroHandler)
+	{
+		parser->MacroHandler = URCL_BasicMacroHandlerEx;
+		parser->MacroHandlerData = URCL_MacroHandlerData;
+	}
+	else if (URCL_MacroHandler == URCL_NoMacroHandler)
+	{
+		URCL_ClearParserMacroHandler(parser);
+	}
+	else
+	{
+		parser->MacroHandler = URCL_InvokeGlobalMacroHandler;
+		parser->MacroHandlerData = URCL_MacroHandlerData;
+	}
+
+	if (URCL_MacroOperandHandler != 0) parser->MacroOperandHandler = URCL_InvokeGlobalMacroOperandHandler;
+	if (URCL_MacroInstructionHandler != 0) parser->MacroInstructionHandler = URCL_InvokeGlobalMacroInstructionHandler;
+	parser->TypedMacroHandlerData = URCL_TypedMacroHandlerData;
+}
+
 unsigned long long URCL_GetMaxUnsignedValue(unsigned long long size)
 {
 	unsigned long long result = 0;
@@ -382,1034 +1611,4135 @@ bool URCL_CharIsDigit(URCL_Char value)
 	return value >= '0' && value <= '9';
 }
 
-bool URCL_CharIsWhitespace(URCL_Char value)
+#define URCL_CharClass_Whitespace 1
+#define URCL_CharClass_OperandEnd 2
+
+const unsigned char URCL_AsciiCharClasses[128] =
 {
-	switch (value)
-	{
-		case 0x0009:
-		case 0x000A:
-		case 0x000B:
-		case 0x000C:
-		case 0x000D:
-		case 0x0020:
-		case 0x0085:
-		case 0x00A0:
-		case 0x1680:
-		case 0x2000:
-		case 0x2001:
-		case 0x2002:
-		case 0x2003:
-		case 0x2004:
-		case 0x2005:
-		case 0x2006:
-		case 0x2007:
-		case 0x2008:
-		case 0x2009:
-		case 0x200A:
-		case 0x2028:
-		case 0x2029:
-		case 0x202F:
-		case 0x205F:
-		case 0x3000:
-			return true;
-		default:
-			return false;
-	}
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+#ifdef URCL_Utf8
+	#define URCL_SwarLanes 8
+	#define URCL_SwarLaneBits 8
+	#define URCL_SwarOnes 0x0101010101010101ULL
+	#define URCL_SwarHighBits 0x8080808080808080ULL
+	#define URCL_SwarLowBits 0x7F7F7F7F7F7F7F7FULL
+	#define URCL_SwarNonAsciiBits 0x8080808080808080ULL
+#else
+	#define URCL_SwarLanes 4
+	#define URCL_SwarLaneBits 16
+	#define URCL_SwarOnes 0x0001000100010001ULL
+	#define URCL_SwarHighBits 0x8000800080008000ULL
+	#define URCL_SwarLowBits 0x7FFF7FFF7FFF7FFFULL
+	#define URCL_SwarNonAsciiBits 0xFF80FF80FF80FF80ULL
+#endif
+
+unsigned long long URCL_SwarLoad(const URCL_Char* value)
+{
+#ifdef URCL_Utf8
+	return ((unsigned long long)value[0]) | (((unsigned long long)value[1]) << 8) | (((unsigned long long)value[2]) << 16) | (((unsigned long long)value[3]) << 24) |
+		(((unsigned long long)value[4]) << 32) | (((unsigned long long)value[5]) << 40) | (((unsigned long long)value[6]) << 48) | (((unsigned long long)value[7]) << 56);
+#else
+	return ((unsigned long long)value[0]) | (((unsigned long long)value[1]) << 16) | (((unsigned long long)value[2]) << 32) | (((unsigned long long)value[3]) << 48);
+#endif
 }
 
-URCL_Char URCL_CharToLower(URCL_Char value)
+unsigned long long URCL_SwarZeroLanes(unsigned long long chars)
 {
-	if (value >= 'A' && value <= 'Z') return (value - 'A') + 'a';
-	else return value;
+	return ~(((chars & URCL_SwarLowBits) + URCL_SwarLowBits) | chars) & URCL_SwarHighBits;
 }
 
-URCL_Char URCL_CharToUpper(URCL_Char value)
+unsigned long long URCL_SwarEqualLanes(unsigned long long chars, URCL_Char value)
 {
-	if (value >= 'a' && value <= 'z') return (value - 'a') + 'A';
-	else return value;
+	return URCL_SwarZeroLanes(chars ^ (URCL_SwarOnes * value));
 }
 
-unsigned long URCL_CharsLength(const URCL_Char* chars)
+unsigned long long URCL_SwarLessLanes(unsigned long long chars, URCL_Char value)
 {
-	unsigned long result = 0;
-	for (; chars[result] != 0; result++);
-	return result;
+	return ~((chars | URCL_SwarHighBits) - (URCL_SwarOnes * value)) & ~chars & URCL_SwarHighBits;
 }
 
-bool URCL_IsStringEqualCaseInsensitive(const URCL_Char* a, unsigned long aLength, const URCL_Char* b, unsigned long bLength)
+bool URCL_SwarIsAsciiWhitespace(unsigned long long chars, bool includeNewLine)
 {
-	if (aLength != bLength) return false;
+	unsigned long long whitespace = (URCL_SwarLessLanes(chars, 0x000E) & ~URCL_SwarLessLanes(chars, 0x0009)) | URCL_SwarEqualLanes(chars, ' ');
+	if (!includeNewLine) whitespace &= ~URCL_SwarEqualLanes(chars, '\n');
+	return whitespace == URCL_SwarHighBits;
+}
 
-	for (unsigned long i = 0; i < aLength; i++)
-	{
-		if (URCL_CharToUpper(a[i]) != URCL_CharToUpper(b[i])) return false;
-	}
+bool URCL_SwarHasOperandEnd(unsigned long long chars)
+{
+	return ((chars & URCL_SwarNonAsciiBits) != 0) || ((URCL_SwarLessLanes(chars, 0x0021) | URCL_SwarEqualLanes(chars, ',')) != 0);
+}
 
-	return true;
+#ifdef URCL_Sse2
+	#ifdef URCL_Utf8
+		#define URCL_ScanLanes 16
+	#else
+		#define URCL_ScanLanes 8
+	#endif
+	#define URCL_ScanAllLanes ((1ULL << URCL_ScanLanes) - 1)
+
+__m128i URCL_Sse2Load(const URCL_Char* value)
+{
+	return _mm_loadu_si128((const __m128i*)value);
 }
 
-unsigned long URCL_GetWhitespaceLength(const URCL_Char* value, unsigned long length, bool includeNewLine)
+unsigned long long URCL_Sse2LaneMask(__m128i lanes)
 {
-	unsigned long result = 0;
-	for (; result < length; result++)
-	{
-		if (!URCL_CharIsWhitespace(value[result]) || (!includeNewLine && (value[result] == '\n'))) break;
-	}
-	return result;
+#ifdef URCL_Utf8
+	return (unsigned int)_mm_movemask_epi8(lanes);
+#else
+	return (unsigned int)_mm_movemask_epi8(_mm_packs_epi16(lanes, _mm_setzero_si128()));
+#endif
 }
 
-unsigned long URCL_GetOperandLength(const URCL_Char* value, unsigned long length)
+__m128i URCL_Sse2EqualLanes(__m128i chars, URCL_Char value)
 {
-	unsigned long result = 0;
-	for (; result < length; result++)
-	{
-		if (URCL_CharIsWhitespace(value[result]) || value[result] == ',') break;
-	}
-	return result;
+#ifdef URCL_Utf8
+	return _mm_cmpeq_epi8(chars, _mm_set1_epi8((char)value));
+#else
+	return _mm_cmpeq_epi16(chars, _mm_set1_epi16((short)value));
+#endif
 }
 
-unsigned long URCL_GetLineLength(const URCL_Char* value, unsigned long length)
+__m128i URCL_Sse2RangeLanes(__m128i chars, URCL_Char first, URCL_Char last)
 {
-	unsigned long result = 0;
-	URCL_Char lastChar = 0;
-	bool isInComment = false;
+#ifdef URCL_Utf8
+	__m128i offsets = _mm_sub_epi8(chars, _mm_set1_epi8((char)first));
+	return _mm_cmpeq_epi8(_mm_subs_epu8(offsets, _mm_set1_epi8((char)(last - first))), _mm_setzero_si128());
+#else
+	__m128i offsets = _mm_sub_epi16(chars, _mm_set1_epi16((short)first));
+	return _mm_cmpeq_epi16(_mm_subs_epu16(offsets, _mm_set1_epi16((short)(last - first))), _mm_setzero_si128());
+#endif
+}
+
+unsigned long long URCL_ScanEqualLanes(const URCL_Char* value, URCL_Char match)
+{
+	return URCL_Sse2LaneMask(URCL_Sse2EqualLanes(URCL_Sse2Load(value), match));
+}
+
+bool URCL_ScanIsAsciiWhitespace(const URCL_Char* value, bool includeNewLine)
+{
+	__m128i chars = URCL_Sse2Load(value);
+	__m128i whitespace = _mm_or_si128(URCL_Sse2RangeLanes(chars, 0x0009, 0x000D), URCL_Sse2EqualLanes(chars, ' '));
+	if (!includeNewLine) whitespace = _mm_andnot_si128(URCL_Sse2EqualLanes(chars, '\n'), whitespace);
+	return URCL_Sse2LaneMask(whitespace) == URCL_ScanAllLanes;
+}
+
+bool URCL_ScanHasOperandEnd(const URCL_Char* value)
+{
+	__m128i chars = URCL_Sse2Load(value);
+	__m128i operand = _mm_andnot_si128(URCL_Sse2EqualLanes(chars, ','), URCL_Sse2RangeLanes(chars, 0x0021, 0x007F));
+	return URCL_Sse2LaneMask(operand) != URCL_ScanAllLanes;
+}
+#else
+	#define URCL_ScanLanes URCL_SwarLanes
+
+unsigned long long URCL_ScanEqualLanes(const URCL_Char* value, URCL_Char match)
+{
+	return URCL_SwarEqualLanes(URCL_SwarLoad(value), match);
+}
+
+bool URCL_ScanIsAsciiWhitespace(const URCL_Char* value, bool includeNewLine)
+{
+	return URCL_SwarIsAsciiWhitespace(URCL_SwarLoad(value), includeNewLine);
+}
+
+bool URCL_ScanHasOperandEnd(const URCL_Char* value)
+{
+	return URCL_SwarHasOperandEnd(URCL_SwarLoad(value));
+}
+#endif
+
+#define URCL_SwarDigitsPerStep 8
+
+bool URCL_SwarTryGetDigitLanes(unsigned long long chars, unsigned long long base, unsigned long long* result)
+{
+	unsigned long long digits = ~URCL_SwarLessLanes(chars, '0') & URCL_SwarLessLanes(chars, (URCL_Char)('0' + (base < 10 ? base : 10)));
+
+	if (base == 16)
+	{
+		unsigned long long lower = chars | (URCL_SwarOnes * 0x20);
+		unsigned long long letters = ~URCL_SwarLessLanes(lower, 'a') & URCL_SwarLessLanes(lower, 'g');
+		if ((digits | letters) != URCL_SwarHighBits) return false;
+
+		*result = (lower & (URCL_SwarOnes * 0x0F)) + ((letters >> (URCL_SwarLaneBits - 1)) * 9);
+		return true;
+	}
+
+	if (digits != URCL_SwarHighBits) return false;
+
+	*result = chars - (URCL_SwarOnes * '0');
+	return true;
+}
+
+bool URCL_SwarTryLoadDigits(const URCL_Char* value, unsigned long long base, unsigned long long* result)
+{
+	unsigned long long digits = 0;
+
+	for (size_t i = 0; i < URCL_SwarDigitsPerStep; i += URCL_SwarLanes)
+	{
+		unsigned long long lanes = 0;
+		if (!URCL_SwarTryGetDigitLanes(URCL_SwarLoad(value + i), base, &lanes)) return false;
+
+#ifndef URCL_Utf8
+		lanes = (lanes | (lanes >> 8)) & 0x0000FFFF0000FFFFULL;
+		lanes = (lanes | (lanes >> 16)) & 0x00000000FFFFFFFFULL;
+#endif
+		digits |= lanes << (i * 8);
+	}
+
+	digits = ((digits * base) + (digits >> 8)) & 0x00FF00FF00FF00FFULL;
+	digits = ((digits * (base * base)) + (digits >> 16)) & 0x0000FFFF0000FFFFULL;
+	*result = ((digits * (base * base * base * base)) + (digits >> 32)) & 0x00000000FFFFFFFFULL;
+	return true;
+}
+
+bool URCL_CodePointIsWhitespace(unsigned long value)
+{
+	if (value < 0x80) return (URCL_AsciiCharClasses[value] & URCL_CharClass_Whitespace) != 0;
+
+	switch (value)
+	{
+		case 0x0085:
+		case 0x00A0:
+		case 0x1680:
+		case 0x2000:
+		case 0x2001:
+		case 0x2002:
+		case 0x2003:
+		case 0x2004:
+		case 0x2005:
+		case 0x2006:
+		case 0x2007:
+		case 0x2008:
+		case 0x2009:
+		case 0x200A:
+		case 0x2028:
+		case 0x2029:
+		case 0x202F:
+		case 0x205F:
+		case 0x3000:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool URCL_CharIsWhitespace(URCL_Char value)
+{
+#ifdef URCL_Utf8
+	return (value < 0x80) && URCL_CodePointIsWhitespace(value);
+#else
+	return URCL_CodePointIsWhitespace(value);
+#endif
+}
+
+size_t URCL_GetWhitespaceCharLength(const URCL_Char* value, size_t length)
+{
+#ifdef URCL_Utf8
+	if (value[0] < 0x80) return URCL_CodePointIsWhitespace(value[0]) ? 1 : 0;
+
+	if ((length >= 2) && ((value[0] & 0xE0) == 0xC0) && ((value[1] & 0xC0) == 0x80))
+	{
+		return URCL_CodePointIsWhitespace(((value[0] & 0x1FUL) << 6) | (value[1] & 0x3FUL)) ? 2 : 0;
+	}
+	else if ((length >= 3) && ((value[0] & 0xF0) == 0xE0) && ((value[1] & 0xC0) == 0x80) && ((value[2] & 0xC0) == 0x80))
+	{
+		return URCL_CodePointIsWhitespace(((value[0] & 0x0FUL) << 12) | ((value[1] & 0x3FUL) << 6) | (value[2] & 0x3FUL)) ? 3 : 0;
+	}
+
+	return 0;
+#else
+	(void)length;
+	return URCL_CodePointIsWhitespace(value[0]) ? 1 : 0;
+#endif
+}
+
+URCL_Char URCL_CharToLower(URCL_Char value)
+{
+	if (value >= 'A' && value <= 'Z') return (value - 'A') + 'a';
+	else return value;
+}
+
+URCL_Char URCL_CharToUpper(URCL_Char value)
+{
+	if (value >= 'a' && value <= 'z') return (value - 'a') + 'A';
+	else return value;
+}
+
+size_t URCL_CharsLength(const URCL_Char* chars)
+{
+	size_t result = 0;
+	for (; chars[result] != 0; result++);
+	return result;
+}
+
+bool URCL_IsStringEqualCaseInsensitive(const URCL_Char* a, size_t aLength, const URCL_Char* b, size_t bLength)
+{
+	if (aLength != bLength) return false;
+
+	for (size_t i = 0; i < aLength; i++)
+	{
+		if (URCL_CharToUpper(a[i]) != URCL_CharToUpper(b[i])) return false;
+	}
+
+	return true;
+}
+
+size_t URCL_GetWhitespaceLength(const URCL_Char* value, size_t length, bool includeNewLine)
+{
+	size_t result = 0;
+	while (((length - result) >= URCL_ScanLanes) && URCL_ScanIsAsciiWhitespace(value + result, includeNewLine)) result += URCL_ScanLanes;
+
+	while (result < length)
+	{
+		if (!includeNewLine && (value[result] == '\n')) break;
+
+		size_t charLength = URCL_GetWhitespaceCharLength(value + result, length - result);
+		if (charLength == 0) break;
+		result += charLength;
+	}
+	return result;
+}
+
+size_t URCL_GetOperandLength(const URCL_Char* value, size_t length)
+{
+	size_t result = 0;
+	while (((length - result) >= URCL_ScanLanes) && !URCL_ScanHasOperandEnd(value + result)) result += URCL_ScanLanes;
+
+	for (; result < length; result++)
+	{
+		URCL_Char current = value[result];
+		if (current < 0x80)
+		{
+			if ((URCL_AsciiCharClasses[current] & URCL_CharClass_OperandEnd) != 0) break;
+		}
+		else if (URCL_GetWhitespaceCharLength(value + result, length - result) != 0) break;
+	}
+	return result;
+}
+
+size_t URCL_GetLineLength(const URCL_Char* value, size_t length)
+{
+	size_t result = 0;
+	URCL_Char lastChar = 0;
+	bool isInComment = false;
 
 	for (; result < length; result++)
 	{
+		while ((length - result) >= URCL_ScanLanes)
+		{
+			if (isInComment ? (URCL_ScanEqualLanes(value + result, '/') != 0) : ((URCL_ScanEqualLanes(value + result, '*') | URCL_ScanEqualLanes(value + result, '\n')) != 0)) break;
+
+			result += URCL_ScanLanes;
+			lastChar = value[result - 1];
+		}
+		if (result == length) break;
+
 		if (isInComment)
 		{
 			if (value[result] == '/' && lastChar == '*') isInComment = false;
 		}
-		else
+		else
+		{
+			if (value[result] == '*' && lastChar == '/') isInComment = true;
+			else if (value[result] == '\n') break;
+		}
+		lastChar = value[result];
+	}
+
+	return result;
+}
+
+#define URCL_BasicMacroCount 7
+
+const URCL_Char* URCL_BasicMacroNames[URCL_BasicMacroCount] =
+{
+	URCL_Text("@MAX"), URCL_Text("@SMAX"), URCL_Text("@MSB"), URCL_Text("@SMSB"), URCL_Text("@LHALF"), URCL_Text("@UHALF"), URCL_Text("@BITS")
+};
+
+const size_t URCL_BasicMacroNameLengths[URCL_BasicMacroCount] = { 4, 5, 4, 5, 6, 6, 5 };
+
+////description Gets the value of the basic macro with the specified name for the target bits of the specified parser. The values are computed once per target bits and cached in the parser. Returns true if the name is a basic macro or false otherwise.
+bool URCL_TryGetBasicMacroValue(URCL_Parser* parser, const URCL_Char* name, size_t nameLength, unsigned long long* result)
+{
+	if (parser->MacroValueBits != parser->TargetBits)
+	{
+		unsigned long long size = parser->TargetBits / 8;
+		parser->MacroValues[0] = URCL_GetMaxUnsignedValue(size);
+		parser->MacroValues[1] = URCL_GetMaxSignedValue(size);
+		parser->MacroValues[2] = URCL_GetMostSignificantBit(size);
+		parser->MacroValues[3] = URCL_GetSecondMostSignificantBit(size);
+		parser->MacroValues[4] = URCL_GetLowerBits(size);
+		parser->MacroValues[5] = URCL_GetUpperBits(size);
+		parser->MacroValues[6] = parser->TargetBits;
+		parser->MacroValueBits = parser->TargetBits;
+	}
+
+	for (size_t i = 0; i < URCL_BasicMacroCount; i++)
+	{
+		if ((nameLength == URCL_BasicMacroNameLengths[i]) && URCL_IsStringEqualCaseInsensitive(name, nameLength, URCL_BasicMacroNames[i], nameLength))
+		{
+			*result = parser->MacroValues[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool URCL_BasicMacroHandlerEx(URCL_Parser* parser, void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+{
+	size_t nameLength = 0;
+	for (; name[nameLength] != 0; nameLength++);
+
+	unsigned long long value = 0;
+	if (URCL_TryGetBasicMacroValue(parser, name, nameLength, &value))
+	{
+		URCL_Arena* arena = parser->Arena;
+		parser->Arena = 0;
+		*result = URCL_ValueToString(parser, value);
+		parser->Arena = arena;
+		return !URCL_ParserHasError(parser);
+	}
+	else
+	{
+		URCL_SetParserError(parser, URCL_Error_UnknownMacro, source, nameLength);
+		return false;
+	}
+}
+
+bool URCL_BasicMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	bool returnValue = URCL_BasicMacroHandlerEx(&parser, data, name, source, result);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+bool URCL_InvokeMacroHandler(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_Char** result)
+{
+	URCL_Char* name = URCL_Substring(parser, value, 0, URCL_GetOperandLength(value, length));
+	bool returnValue = parser->MacroHandler(parser, parser->MacroHandlerData, name, value, result);
+	URCL_Release(parser, name);
+	return returnValue;
+}
+
+bool URCL_TryParseOperandWithPrefix(URCL_Parser* parser, URCL_Char prefix, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	if (length == 0 || value[0] != prefix)
+	{
+		URCL_SetParserError(parser, URCL_Error_MissingOperandPrefix, value, 1);
+		return false;
+	}
+
+	*resultLength = URCL_GetOperandLength(value, length);
+	*result = URCL_GetTokenString(parser, value, *resultLength);
+
+	return *result != 0;
+}
+
+bool URCL_TryParseOperandWithPrefixes(URCL_Parser* parser, const URCL_Char* prefixes, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	for (size_t i = 0; prefixes[i] != 0; i++)
+	{
+		if (URCL_TryParseOperandWithPrefix(parser, prefixes[i], value, length, result, resultLength))
+		{
+			URCL_ResetParserError(parser);
+			return true;
+		}
+		else
+		{
+			if (prefixes[i + 1] != 0) URCL_ResetParserError(parser);
+		}
+	}
+
+	return false;
+}
+
+bool URCL_TryGetPrefixedOperandLength(URCL_Parser* parser, const URCL_Char* prefixes, const URCL_Char* value, size_t length, size_t* resultLength)
+{
+	for (size_t i = 0; prefixes[i] != 0; i++)
+	{
+		if (length > 0 && value[0] == prefixes[i])
+		{
+			URCL_ResetParserError(parser);
+			*resultLength = URCL_GetOperandLength(value, length);
+			return true;
+		}
+	}
+
+	URCL_SetParserError(parser, URCL_Error_MissingOperandPrefix, value, 1);
+	return false;
+}
+
+bool URCL_TryParseAny(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	*resultLength = URCL_GetOperandLength(value, length);
+	*result = URCL_GetTokenString(parser, value, *resultLength);
+
+	return *result != 0;
+}
+
+bool URCL_TryParseLabel(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	return URCL_TryParseOperandWithPrefixes(parser, URCL_Prefixes_Label, value, length, result, resultLength);
+}
+
+bool URCL_TryParsePort(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	return URCL_TryParseOperandWithPrefixes(parser, URCL_Prefixes_Port, value, length, result, resultLength);
+}
+
+unsigned long long URCL_GetDigitValue(URCL_Char value)
+{
+	if (value >= '0' && value <= '9') return value - '0';
+	else if (value >= 'A' && value <= 'Z') return (value - 'A') + 10;
+	else if (value >= 'a' && value <= 'z') return (value - 'a') + 10;
+	else return 36;
+}
+
+bool URCL_TryParseDigits(URCL_Parser* parser, const URCL_Char* value, size_t length, size_t prefixLength, unsigned long long base, const URCL_Char* charError, unsigned long long* result)
+{
+	unsigned long long maxValue = ~0ULL;
+	unsigned long long stepBase = base * base * base * base;
+	stepBase *= stepBase;
+
+	bool overflow = false;
+	size_t i = prefixLength;
+	*result = 0;
+
+	for (; (length - i) >= URCL_SwarDigitsPerStep; i += URCL_SwarDigitsPerStep)
+	{
+		unsigned long long digits = 0;
+		if (!URCL_SwarTryLoadDigits(value + i, base, &digits)) break;
+
+		if (((*result >> 32) != 0) && ((*result > (maxValue / stepBase)) || ((*result * stepBase) > (maxValue - digits)))) overflow = true;
+		*result = (*result * stepBase) + digits;
+	}
+
+	for (; i < length; i++)
+	{
+		unsigned long long digit = URCL_GetDigitValue(value[i]);
+		if (digit >= base)
+		{
+			URCL_SetParserError(parser, charError, value + i, 1);
+			return false;
+		}
+
+		if (((*result >> 60) != 0) && ((*result > (maxValue / base)) || ((*result * base) > (maxValue - digit)))) overflow = true;
+		*result = (*result * base) + digit;
+	}
+
+	if (overflow)
+	{
+		URCL_SetParserError(parser, URCL_Error_ImmediateTooLarge, value, length);
+		return false;
+	}
+
+	return true;
+}
+
+bool URCL_TryParseImmediate(URCL_Parser* parser, const URCL_Char* value, size_t length, unsigned long long* result, size_t* resultLength)
+{
+	if (URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Immediate, value, length, resultLength))
+	{
+		if (*resultLength > 2 && value[0] == '0' && !URCL_CharIsDigit(value[1]))
+		{
+			if (value[1] == 'x' || value[1] == 'X')
+			{
+				return URCL_TryParseDigits(parser, value, *resultLength, 2, 16, URCL_Error_UnexpectedHexChar, result);
+			}
+			else if (value[1] == 'o' || value[1] == 'O')
+			{
+				return URCL_TryParseDigits(parser, value, *resultLength, 2, 8, URCL_Error_UnexpectedOctChar, result);
+			}
+			else if (value[1] == 'b' || value[1] == 'B')
+			{
+				return URCL_TryParseDigits(parser, value, *resultLength, 2, 2, URCL_Error_UnexpectedBinChar, result);
+			}
+			else
+			{
+				URCL_SetParserError(parser, URCL_Error_UnknownImmTypePrefix, value + 1, 1);
+				return false;
+			}
+		}
+		else
+		{
+			return URCL_TryParseDigits(parser, value, *resultLength, 0, 10, URCL_Error_UnexpectedDecChar, result);
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool URCL_TryParseRelative(URCL_Parser* parser, const URCL_Char* value, size_t length, long long* result, size_t* resultLength)
+{
+	if (URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Relative, value, length, resultLength))
+	{
+		if ((*resultLength > 2) || (*resultLength == 2 && URCL_CharIsDigit(value[1])))
+		{
+			size_t offset = 1;
+			bool negative = false;
+			
+			if (value[offset] == '-')
+			{
+				negative = true;
+				offset++;
+			}
+			else if (value[offset] == '+')
+			{
+				offset++;
+			}
+			else if (!URCL_CharIsDigit(value[offset]))
+			{
+				URCL_SetParserError(parser, URCL_Error_UnexpectedRelativeChar, value + offset, 1);
+				return false;
+			}
+
+			unsigned long long immediateValue;
+			size_t immediateLength;
+			if (URCL_TryParseImmediate(parser, value + offset, *resultLength - offset, &immediateValue, &immediateLength))
+			{
+				if (immediateValue > URCL_GetMaxSignedValue(sizeof(long long)))
+				{
+					URCL_SetParserError(parser, URCL_Error_RelativeValueTooLarge, value + offset, *resultLength);
+					return false;
+				}
+
+				if (negative) *result = -((long long)immediateValue);
+				else *result = (long long)immediateValue;
+
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else
+		{
+			URCL_SetParserError(parser, URCL_Error_InvalidRelativeValue, value + 1, 1);
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool URCL_TryParseMemoryAddress(URCL_Parser* parser, const URCL_Char* value, size_t length, unsigned long long* result, size_t* resultLength)
+{
+	if (URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Memory, value, length, resultLength))
+	{
+		if (*resultLength > 1)
+		{
+			size_t immediateLength;
+			return URCL_TryParseImmediate(parser, value + 1, *resultLength - 1, result, &immediateLength);
+		}
+		else
+		{
+			URCL_SetParserError(parser, URCL_Error_InvalidMemoryAddress, value + 1, 1);
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool URCL_TryParseRegister(URCL_Parser* parser, const URCL_Char* value, size_t length, unsigned long long* result, bool* isSpecialRegister, size_t* resultLength)
+{
+	if (URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Register, value, length, resultLength))
+	{
+		if (*resultLength > 1)
+		{
+			size_t immediateLength;
+			*isSpecialRegister = false;
+			return URCL_TryParseImmediate(parser, value + 1, *resultLength - 1, result, &immediateLength);
+		}
+		else
+		{
+			URCL_SetParserError(parser, URCL_Error_InvalidRegisterIndex, value + 1, 1);
+			return false;
+		}
+	}
+	else
+	{
+		URCL_ResetParserError(parser);
+
+		*resultLength = URCL_GetOperandLength(value, length);
+
+		if (URCL_IsStringEqualCaseInsensitive(URCL_Text("SP"), 2, value, *resultLength))
+		{
+			*isSpecialRegister = true;
+			*result = URCL_Register_StackPointer;
+			return true;
+		}
+		else if (URCL_IsStringEqualCaseInsensitive(URCL_Text("PC"), 2, value, *resultLength))
+		{
+			*isSpecialRegister = true;
+			*result = URCL_Register_ProgramCounter;
+			return true;
+		}
+		else
+		{
+			URCL_SetParserError(parser, URCL_Error_UnknownRegister, value, *resultLength);
+			return false;
+		}
+	}
+}
+
+bool URCL_TryParseMacro(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_Char** result, size_t* resultLength)
+{
+	if (URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Macro, value, length, resultLength))
+	{
+		if (URCL_InvokeMacroHandler(parser, value, *resultLength, result))
+		{
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool URCL_TryParseOperandWithWidth(URCL_Parser* parser, const URCL_Char* value, size_t length, bool checkWidth, URCL_OperandInfo* result, size_t* resultLength);
+
+bool URCL_FitsTargetBits(URCL_Parser* parser, unsigned long long value)
+{
+	return (parser->TargetBits >= 64) || (value < (1ULL << parser->TargetBits));
+}
+
+bool URCL_FitsTargetBitsSigned(URCL_Parser* parser, long long value)
+{
+	if (parser->TargetBits == 0) return value == 0;
+
+	return (parser->TargetBits >= 64) || ((value >= -(1LL << (parser->TargetBits - 1))) && (value < (1LL << (parser->TargetBits - 1))));
+}
+
+bool URCL_TryEnterMacro(URCL_Parser* parser, const URCL_Char* value, size_t length)
+{
+	if (!URCL_TryCheckParserLimit(parser, parser->MacroDepth + 1, parser->Limits.MaxMacroDepth, URCL_Error_MacroDepthLimit, value, URCL_GetOperandLength(value, length))) return false;
+
+	parser->MacroDepth++;
+	return true;
+}
+
+void URCL_LeaveMacro(URCL_Parser* parser, const URCL_Char* value, size_t length)
+{
+	parser->MacroDepth--;
+	if (parser->Error.Message == URCL_Error_MacroDepthLimit) URCL_SetParserError(parser, URCL_Error_MacroDepthLimit, value, URCL_GetOperandLength(value, length));
+}
+
+bool URCL_TryParseMacroOperand(URCL_Parser* parser, const URCL_Char* value, size_t length, bool checkWidth, URCL_OperandInfo* result, size_t* resultLength)
+{
+	if (parser->Defines != 0)
+	{
+		if (!URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Macro, value, length, resultLength)) return false;
+
+		const URCL_OperandInfo* define = URCL_FindDefine(parser->Defines, value + 1, *resultLength - 1);
+		if (define != 0)
+		{
+			*result = *define;
+			result->IsSourceView = true;
+			return URCL_TryOwnOperandString(parser, result);
+		}
+	}
+
+	if (parser->MacroOperandHandler != 0)
+	{
+		if (!URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Macro, value, length, resultLength)) return false;
+
+		if (!parser->MacroOperandHandler(parser, parser->TypedMacroHandlerData, value, *resultLength, result))
+		{
+			if (!URCL_ParserHasError(parser)) URCL_SetParserError(parser, URCL_Error_UnknownMacro, value, *resultLength);
+			result->Type = URCL_OperandType_None;
+			result->StringValue = 0;
+			result->StringLength = 0;
+			return false;
+		}
+
+		result->IsSourceView = true;
+		return URCL_TryOwnOperandString(parser, result);
+	}
+	else if (parser->MacroHandler == URCL_BasicMacroHandlerEx)
+	{
+		if (!URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Macro, value, length, resultLength)) return false;
+
+		if (!URCL_TryGetBasicMacroValue(parser, value, *resultLength, &(result->ImmediateValue)))
+		{
+			URCL_SetParserError(parser, URCL_Error_UnknownMacro, value, *resultLength);
+			return false;
+		}
+
+		result->Type = URCL_OperandType_Immediate;
+		result->StringValue = URCL_GetTokenString(parser, value, *resultLength);
+		result->StringLength = *resultLength;
+		result->IsSourceView = parser->SourceViews;
+		return result->StringValue != 0;
+	}
+
+	URCL_Char* resultString = 0;
+	if (URCL_TryParseMacro(parser, value, length, &resultString, resultLength))
+	{
+		size_t operandLength = 0;
+		for (; resultString[operandLength] != 0; operandLength++);
+
+		size_t parsedLength = 0;
+		if (URCL_TryParseOperandWithWidth(parser, resultString, operandLength, checkWidth, result, &parsedLength))
+		{
+			bool owned = URCL_TryOwnOperandString(parser, result);
+			URCL_free(resultString);
+			return owned;
+		}
+		else
+		{
+			URCL_free(resultString);
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool URCL_TryParseOperandWithWidth(URCL_Parser* parser, const URCL_Char* value, size_t length, bool checkWidth, URCL_OperandInfo* result, size_t* resultLength)
+{
+	size_t startPadding = URCL_GetWhitespaceLength(value, length, false);
+	value += startPadding;
+	length -= startPadding;
+
+	if (length == 0)
+	{
+		URCL_SetParserError(parser, URCL_Error_ExpectedOperand, value, 0);
+		return false;
+	}
+
+	result->Type = URCL_OperandType_None;
+	result->ImmediateValue = 0;
+	result->StringValue = 0;
+	result->StringLength = 0;
+	result->IsSourceView = parser->SourceViews;
+
+	size_t trimmedLength = 0;
+	bool isSpecialRegister = false;
+	bool parsed = false;
+	switch (value[0])
+	{
+		case '.':
+			if (URCL_TryParseLabel(parser, value, length, &(result->StringValue), &trimmedLength))
+			{
+				result->Type = URCL_OperandType_Label;
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+		case '%':
+			if (URCL_TryParsePort(parser, value, length, &(result->StringValue), &trimmedLength))
+			{
+				URCL_ResetParserError(parser);
+				result->Type = URCL_OperandType_Port;
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			if (URCL_TryParseImmediate(parser, value, length, &(result->ImmediateValue), &trimmedLength))
+			{
+				if (checkWidth && !URCL_FitsTargetBits(parser, result->ImmediateValue))
+				{
+					URCL_SetParserError(parser, URCL_Error_ImmediateTooLarge, value, trimmedLength);
+					break;
+				}
+
+				URCL_ResetParserError(parser);
+				result->Type = URCL_OperandType_Immediate;
+				result->StringValue = URCL_GetTokenString(parser, value, trimmedLength);
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+		case '~':
+			if (URCL_TryParseRelative(parser, value, length, (long long*)&(result->ImmediateValue), &trimmedLength))
+			{
+				if (checkWidth && !URCL_FitsTargetBitsSigned(parser, (long long)result->ImmediateValue))
+				{
+					URCL_SetParserError(parser, URCL_Error_ImmediateTooLarge, value, trimmedLength);
+					break;
+				}
+
+				URCL_ResetParserError(parser);
+				result->Type = URCL_OperandType_Relative;
+				result->StringValue = URCL_GetTokenString(parser, value, trimmedLength);
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+		case 'M':
+		case 'm':
+		case '#':
+			if (URCL_TryParseMemoryAddress(parser, value, length, &(result->ImmediateValue), &trimmedLength))
+			{
+				if (checkWidth && !URCL_FitsTargetBits(parser, result->ImmediateValue))
+				{
+					URCL_SetParserError(parser, URCL_Error_ImmediateTooLarge, value, trimmedLength);
+					break;
+				}
+
+				URCL_ResetParserError(parser);
+				result->Type = URCL_OperandType_MemoryAddress;
+				result->StringValue = URCL_GetTokenString(parser, value, trimmedLength);
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+		case '@':
+			if (URCL_TryEnterMacro(parser, value, length))
+			{
+				parsed = URCL_TryParseMacroOperand(parser, value, length, checkWidth, result, &trimmedLength);
+				URCL_LeaveMacro(parser, value, length);
+				if (parsed) URCL_ResetParserError(parser);
+			}
+			break;
+		default:
+			if (URCL_TryParseRegister(parser, value, length, &(result->ImmediateValue), &isSpecialRegister, &trimmedLength))
+			{
+				URCL_ResetParserError(parser);
+				result->Type = isSpecialRegister ? URCL_OperandType_SpecialRegister : URCL_OperandType_IndexedRegister;
+				result->StringValue = URCL_GetTokenString(parser, value, trimmedLength);
+				result->StringLength = trimmedLength;
+				parsed = true;
+			}
+			break;
+	}
+
+	if (!parsed)
+	{
+		if ((parser->Error.Message == URCL_Error_ImmediateTooLarge) || URCL_IsParserLimitError(parser))
+		{
+			return false;
+		}
+		else if (URCL_TryParseAny(parser, value, length, &(result->StringValue), &trimmedLength))
+		{
+			URCL_ResetParserError(parser);
+			result->Type = URCL_OperandType_Any;
+			result->StringLength = trimmedLength;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if (URCL_ParserHasError(parser))
+	{
+		result->Type = URCL_OperandType_None;
+		result->ImmediateValue = 0;
+		if (result->StringValue != 0)
+		{
+			if (!result->IsSourceView) URCL_Release(parser, result->StringValue);
+			result->StringValue = 0;
+			result->StringLength = 0;
+		}
+
+		return false;
+	}
+
+	value += trimmedLength;
+	length -= trimmedLength;
+
+	size_t endPadding = URCL_GetWhitespaceLength(value, length, false);
+	*resultLength = startPadding + trimmedLength + endPadding;
+	return true;
+}
+
+////description Attempts to parse the specified source string into an operand using the specified parser. Immediate, memory address, and relative operands must fit in the target bits of the parser unless header fields are allowed, since header values are not machine words. Returns true if successful or false otherwise.
+bool URCL_TryParseOperandEx(URCL_Parser* parser, const URCL_Char* value, size_t length, bool allowHeaderFields, URCL_OperandInfo* result, size_t* resultLength)
+{
+	return URCL_TryParseOperandWithWidth(parser, value, length, !allowHeaderFields, result, resultLength);
+}
+
+////description Attempts to parse the specified source string into an operand using the global parser settings. Returns true if successful or false otherwise.
+bool URCL_TryParseOperand(const URCL_Char* value, size_t length, bool allowHeaderFields, URCL_OperandInfo* result, size_t* resultLength)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	bool returnValue = URCL_TryParseOperandEx(&parser, value, length, allowHeaderFields, result, resultLength);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+size_t URCL_GetCommentLength(const URCL_Char* value, size_t length)
+{
+	size_t result = 0;
+
+	if (length >= 2 && value[0] == '/')
+	{
+		if (value[1] == '/')
+		{
+			while (((length - result) >= URCL_ScanLanes) && (URCL_ScanEqualLanes(value + result, '\n') == 0)) result += URCL_ScanLanes;
+
+			for (; result < length; result++)
+			{
+				if (value[result] == '\n') break;
+			}
+
+			return result;
+		}
+		else if (value[1] == '*')
+		{
+			URCL_Char previousChar = 0;
+			for (; result < length; result++)
+			{
+				while (((length - result) >= URCL_ScanLanes) && (URCL_ScanEqualLanes(value + result, '/') == 0))
+				{
+					result += URCL_ScanLanes;
+					previousChar = value[result - 1];
+				}
+				if (result == length) break;
+
+				URCL_Char currentChar = value[result];
+				
+				if (currentChar == '/' && previousChar == '*')
+				{
+					result++;
+					return result;
+				}
+
+				previousChar = currentChar;
+			}
+		}
+	}
+
+	return 0;
+}
+
+#define URCL_LineTokenKind_Word 1
+#define URCL_LineTokenKind_Comma 2
+#define URCL_MaxLineTokens ((2 * URCL_MaxOperands) + 1)
+
+typedef struct URCL_LineToken
+{
+	unsigned long Kind;
+	size_t Offset;
+	size_t Length;
+} URCL_LineToken;
+
+typedef struct URCL_LineTokens
+{
+	URCL_LineToken Tokens[URCL_MaxLineTokens];
+	size_t Count;
+	size_t Length;
+	bool IsTruncated;
+} URCL_LineTokens;
+
+void URCL_TokenizeLine(const URCL_Char* value, size_t length, URCL_LineTokens* result)
+{
+	size_t offset = 0;
+	result->Count = 0;
+	result->IsTruncated = false;
+
+	while (true)
+	{
+		offset += URCL_GetWhitespaceLength(value + offset, length - offset, false);
+		if ((offset == length) || (value[offset] == '\n')) break;
+
+		size_t commentLength = URCL_GetCommentLength(value + offset, length - offset);
+		if (commentLength != 0)
+		{
+			offset += commentLength;
+			continue;
+		}
+
+		if (result->Count == URCL_MaxLineTokens)
+		{
+			result->IsTruncated = true;
+			break;
+		}
+
+		URCL_LineToken* token = &(result->Tokens[result->Count]);
+		result->Count++;
+
+		token->Offset = offset;
+		if (value[offset] == ',')
+		{
+			token->Kind = URCL_LineTokenKind_Comma;
+			token->Length = 1;
+		}
+		else
+		{
+			token->Kind = URCL_LineTokenKind_Word;
+			token->Length = URCL_GetOperandLength(value + offset, length - offset);
+		}
+		offset += token->Length;
+	}
+
+	result->Length = offset;
+}
+
+bool URCL_HasLineTokensAfter(const URCL_LineTokens* tokens, size_t index)
+{
+	return (index < tokens->Count) || tokens->IsTruncated;
+}
+
+#define URCL_OpcodeHashMultiplier 0x9E3A9513UL
+#define URCL_MaxOpcodeNameLength 8
+
+const unsigned char URCL_OpcodeSlots[256] =
+{
+	0, 0, 16, 0, 0, 0, 57, 0, 35, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 64, 2, 22, 0, 50, 0, 18, 0, 0, 0, 26, 0, 0, 0,
+	0, 44, 60, 34, 62, 0, 40, 0, 0, 63, 0, 0, 0, 0, 51, 67,
+	38, 0, 19, 0, 49, 0, 0, 0, 0, 59, 0, 0, 0, 0, 0, 17,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 46, 7, 0, 0, 0, 41,
+	31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 56, 0, 30, 0, 0,
+	0, 0, 0, 25, 0, 0, 0, 0, 0, 0, 0, 45, 0, 0, 0, 20,
+	0, 0, 43, 0, 13, 0, 0, 77, 0, 0, 0, 0, 0, 0, 0, 65,
+	0, 0, 0, 0, 39, 37, 53, 12, 0, 0, 0, 0, 0, 32, 0, 33,
+	0, 0, 10, 0, 72, 0, 0, 14, 1, 0, 0, 0, 0, 0, 54, 11,
+	0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 75, 73, 0, 0, 0,
+	3, 0, 0, 42, 28, 0, 36, 69, 0, 70, 0, 29, 68, 0, 0, 47,
+	24, 0, 0, 0, 0, 76, 0, 0, 0, 0, 66, 0, 0, 0, 8, 74,
+	52, 0, 27, 0, 0, 0, 0, 0, 58, 61, 48, 6, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 71, 0, 9, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 21, 0, 0, 55, 0, 0, 0, 0, 23, 0, 5
+};
+
+////description Returns the opcode for the specified operation name, or URCL_Opcode_Unknown if the name is not a known instruction or header. Names are matched case-insensitively.
+unsigned long URCL_GetOpcode(const URCL_Char* name, size_t nameLength)
+{
+	if ((nameLength == 0) || (nameLength > URCL_MaxOpcodeNameLength)) return URCL_Opcode_Unknown;
+
+	unsigned long hash = 0;
+	for (size_t i = 0; i < nameLength; i++) hash = ((hash + (name[i] & 0x1F)) * URCL_OpcodeHashMultiplier) & 0xFFFFFFFFUL;
+
+	unsigned long opcode = URCL_OpcodeSlots[hash >> 24];
+	if ((opcode != URCL_Opcode_Unknown) && URCL_IsStringEqualCaseInsensitive(URCL_OpcodeNames[opcode], URCL_OpcodeNameLengths[opcode], name, nameLength)) return opcode;
+	else return URCL_Opcode_Unknown;
+}
+
+////description Returns true if the specified opcode is a known header or false otherwise.
+bool URCL_IsHeaderOpcode(unsigned long opcode)
+{
+	return (opcode >= URCL_Opcode_Bits) && (opcode <= URCL_Opcode_InstructionStorage);
+}
+
+////description Returns true if the specified string matches a known header or false otherwise.
+bool URCL_IsInstructionHeaderName(const URCL_Char* name, size_t nameLength)
+{
+	return URCL_IsHeaderOpcode(URCL_GetOpcode(name, nameLength));
+}
+
+////description Returns true if an instruction is a known header or false otherwise.
+bool URCL_IsInstructionHeader(URCL_InstructionInfo* instruction)
+{
+	return URCL_IsHeaderOpcode(instruction->Opcode);
+}
+
+bool URCL_TryParseInstructionTokens(URCL_Parser* parser, const URCL_Char* value, size_t length, const URCL_LineTokens* tokens, URCL_InstructionInfo* result)
+{
+	URCL_ResetParserError(parser);
+
+	if ((tokens->Count == 0) || (tokens->Tokens[0].Kind != URCL_LineTokenKind_Word))
+	{
+		URCL_SetParserError(parser, URCL_Error_ExpectedOperation, value + (tokens->Count == 0 ? tokens->Length : tokens->Tokens[0].Offset), 0);
+		return false;
+	}
+
+	const URCL_Char* operation = value + tokens->Tokens[0].Offset;
+	size_t operationLength = tokens->Tokens[0].Length;
+	result->Opcode = URCL_GetOpcode(operation, operationLength);
+
+	if (result->Opcode != URCL_Opcode_Unknown)
+	{
+		result->Operation = (URCL_Char*)URCL_OpcodeNames[result->Opcode];
+		result->OperationLength = URCL_OpcodeNameLengths[result->Opcode];
+		result->IsSourceView = true;
+	}
+	else
+	{
+		result->Operation = URCL_GetTokenString(parser, operation, operationLength);
+		result->OperationLength = operationLength;
+		result->IsSourceView = parser->SourceViews;
+	}
+
+	for (size_t i = 0; i < URCL_MaxOperands; i++)
+	{
+		result->Operands[i].Type = URCL_OperandType_None;
+		result->Operands[i].ImmediateValue = 0;
+		result->Operands[i].StringValue = 0;
+		result->Operands[i].StringLength = 0;
+		result->Operands[i].IsSourceView = false;
+	}
+
+	bool isHeader = URCL_IsHeaderOpcode(result->Opcode);
+	size_t index = 1;
+
+	for (size_t i = 0; (i < URCL_MaxOperands) && (index < tokens->Count); i++)
+	{
+		const URCL_LineToken* token = &(tokens->Tokens[index]);
+
+		size_t operandLength = 0;
+		if (!URCL_TryParseOperandWithWidth(parser, value + token->Offset, token->Length, !isHeader, &(result->Operands[i]), &operandLength))
+		{
+			URCL_ReleaseInstructions(parser, result, 1);
+			return false;
+		}
+
+		if (token->Kind == URCL_LineTokenKind_Word) index++;
+
+		if ((index < tokens->Count) && (tokens->Tokens[index].Kind == URCL_LineTokenKind_Comma))
+		{
+			index++;
+
+			if (!URCL_HasLineTokensAfter(tokens, index) && (tokens->Length == length))
+			{
+				size_t comma = tokens->Tokens[index - 1].Offset;
+				if ((comma + 1) == length) URCL_SetParserError(parser, URCL_Error_ExpectedOperand, value + comma, 1);
+				else URCL_SetParserError(parser, URCL_Error_ExpectedOperand, value + length, 0);
+				URCL_ReleaseInstructions(parser, result, 1);
+				return false;
+			}
+		}
+	}
+
+	if (!URCL_ParserHasError(parser) && !URCL_HasLineTokensAfter(tokens, index)) return true;
+
+	URCL_ReleaseInstructions(parser, result, 1);
+	return false;
+}
+
+////description Attempts to parse the specified source string into an instruction using the specified parser. Returns true if successful or false otherwise.
+bool URCL_TryParseInstructionEx(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_InstructionInfo* result, size_t* resultLength)
+{
+	URCL_LineTokens tokens;
+	URCL_TokenizeLine(value, length, &tokens);
+
+	bool parsed = URCL_TryParseInstructionTokens(parser, value, length, &tokens, result);
+	*resultLength = parsed ? tokens.Length : 0;
+	return parsed;
+}
+
+////description Attempts to parse the specified source string into an instruction using the global parser settings. Returns true if successful or false otherwise.
+bool URCL_TryParseInstruction(const URCL_Char* value, size_t length, URCL_InstructionInfo* result, size_t* resultLength)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	bool returnValue = URCL_TryParseInstructionEx(&parser, value, length, result, resultLength);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+bool URCL_TryExpandMacroInstruction(URCL_Parser* parser, const URCL_Char* value, size_t length, URCL_InstructionInfo* result, size_t* resultLength)
+{
+	if (parser->MacroInstructionHandler != 0)
+	{
+		if (!URCL_TryGetPrefixedOperandLength(parser, URCL_Prefixes_Macro, value, length, resultLength)) return false;
+
+		result->Operation = 0;
+		result->OperationLength = 0;
+		result->Opcode = URCL_Opcode_Unknown;
+		for (size_t i = 0; i < URCL_MaxOperands; i++)
+		{
+			result->Operands[i].Type = URCL_OperandType_None;
+			result->Operands[i].ImmediateValue = 0;
+			result->Operands[i].StringValue = 0;
+			result->Operands[i].StringLength = 0;
+		}
+
+		if (!parser->MacroInstructionHandler(parser, parser->TypedMacroHandlerData, value, *resultLength, result))
+		{
+			if (!URCL_ParserHasError(parser)) URCL_SetParserError(parser, URCL_Error_UnknownMacro, value, *resultLength);
+			return false;
+		}
+
+		if (result->OperationLength == 0)
+		{
+			URCL_SetParserError(parser, URCL_Error_ExpectedOperation, value, *resultLength);
+			return false;
+		}
+
+		if (result->Opcode == URCL_Opcode_Unknown) result->Opcode = URCL_GetOpcode(result->Operation, result->OperationLength);
+		if (result->Opcode != URCL_Opcode_Unknown)
+		{
+			result->Operation = (URCL_Char*)URCL_OpcodeNames[result->Opcode];
+			result->OperationLength = URCL_OpcodeNameLengths[result->Opcode];
+		}
+
+		result->IsSourceView = true;
+		for (size_t i = 0; i < URCL_MaxOperands; i++) result->Operands[i].IsSourceView = true;
+	}
+	else
+	{
+		URCL_Char* resultString = 0;
+		if (!URCL_TryParseMacro(parser, value, length, &resultString, resultLength)) return false;
+
+		size_t instructionLength = 0;
+		for (; resultString[instructionLength] != 0; instructionLength++);
+
+		size_t parsedLength = 0;
+		bool parsed = URCL_TryParseInstructionEx(parser, resultString, instructionLength, result, &parsedLength);
+		if (!parsed)
+		{
+			URCL_free(resultString);
+			return false;
+		}
+
+		bool owned = URCL_TryOwnInstructionStrings(parser, result);
+		URCL_free(resultString);
+
+		if (!owned)
+		{
+			URCL_ReleaseInstructions(parser, result, 1);
+			return false;
+		}
+
+		return true;
+	}
+
+	if (!URCL_TryOwnInstructionStrings(parser, result))
+	{
+		URCL_ReleaseInstructions(parser, result, 1);
+		return false;
+	}
+
+	return true;
+}
+
+bool URCL_TryParseMacroInstructionTokens(URCL_Parser* parser, const URCL_Char* value, const URCL_LineTokens* tokens, URCL_InstructionInfo* result)
+{
+	URCL_ResetParserError(parser);
+
+	const URCL_Char* macro = value + tokens->Tokens[0].Offset;
+	size_t macroLength = 0;
+	if (!URCL_TryEnterMacro(parser, macro, tokens->Tokens[0].Length)) return false;
+
+	bool expanded = URCL_TryExpandMacroInstruction(parser, macro, tokens->Tokens[0].Length, result, &macroLength);
+	URCL_LeaveMacro(parser, macro, tokens->Tokens[0].Length);
+	if (!expanded) return false;
+
+	if (!URCL_HasLineTokensAfter(tokens, 1)) return true;
+
+	URCL_ReleaseInstructions(parser, result, 1);
+	return false;
+}
+
+bool URCL_TryParseLabelTokens(URCL_Parser* parser, const URCL_Char* value, const URCL_LineTokens* tokens, URCL_LabelInfo* result)
+{
+	URCL_ResetParserError(parser);
+	if (URCL_HasLineTokensAfter(tokens, 1)) return false;
+
+	size_t labelLength = 0;
+	if (!URCL_TryParseLabel(parser, value + tokens->Tokens[0].Offset, tokens->Tokens[0].Length, &(result->Name), &labelLength)) return false;
+
+	result->NameLength = labelLength;
+	result->IsSourceView = parser->SourceViews;
+	return true;
+}
+
+#define URCL_StatementKind_None 0
+#define URCL_StatementKind_Instruction 1
+#define URCL_StatementKind_Label 2
+#define URCL_StatementKind_Header 3
+
+size_t URCL_GetDefineKeywordLength(const URCL_Char* value, size_t length)
+{
+	size_t keywordLength = URCL_GetOperandLength(value, length);
+	if ((keywordLength == 7) && URCL_IsStringEqualCaseInsensitive(value, keywordLength, URCL_Text("@DEFINE"), 7)) return keywordLength;
+	else return 0;
+}
+
+bool URCL_ContainsDefine(const URCL_Char* source, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		if ((source[i] == '@') && (URCL_GetDefineKeywordLength(source + i, length - i) != 0)) return true;
+	}
+	return false;
+}
+
+bool URCL_TryParseDefineTokens(URCL_Parser* parser, const URCL_Char* value, size_t length, const URCL_LineTokens* tokens)
+{
+	URCL_ResetParserError(parser);
+
+	const URCL_Char* keyword = value + tokens->Tokens[0].Offset;
+	const URCL_Char* name = 0;
+	size_t nameLength = 0;
+
+	if ((tokens->Count > 1) && (tokens->Tokens[1].Kind == URCL_LineTokenKind_Word))
+	{
+		name = value + tokens->Tokens[1].Offset;
+		nameLength = tokens->Tokens[1].Length;
+		if (name[0] == '@')
+		{
+			name++;
+			nameLength--;
+		}
+	}
+
+	if ((nameLength == 0) || (tokens->Count < 3))
+	{
+		const URCL_LineToken* last = &(tokens->Tokens[tokens->Count < 3 ? tokens->Count - 1 : 2]);
+		size_t end = last->Offset;
+		if (tokens->Count < 3)
+		{
+			end += last->Length;
+			end += URCL_GetWhitespaceLength(value + end, length - end, false);
+		}
+		URCL_SetParserError(parser, URCL_Error_InvalidDefine, keyword, (size_t)((value + end) - keyword));
+		return false;
+	}
+
+	URCL_OperandInfo operand;
+	size_t operandLength = 0;
+	if (!URCL_TryParseOperandWithWidth(parser, value + tokens->Tokens[2].Offset, tokens->Tokens[2].Length, true, &operand, &operandLength)) return false;
+
+	bool defined = URCL_TryChargeAllocation(parser, sizeof(URCL_Define) + ((operand.StringValue != 0) ? (operand.StringLength + 1) * sizeof(URCL_Char) : 0)) && URCL_TrySetDefine(parser->Defines, name, nameLength, &operand);
+	if (!operand.IsSourceView) URCL_Release(parser, operand.StringValue);
+
+	if (!defined)
+	{
+		URCL_SetOutOfMemoryError(parser, keyword);
+		return false;
+	}
+
+	if (URCL_HasLineTokensAfter(tokens, 3))
+	{
+		const URCL_LineToken* extra = &(tokens->Tokens[3]);
+		URCL_SetParserError(parser, URCL_Error_InvalidDefine, value + extra->Offset, extra->Length);
+		return false;
+	}
+
+	return true;
+}
+
+bool URCL_TryCheckTokenLengths(URCL_Parser* parser, const URCL_Char* source, const URCL_LineTokens* tokens)
+{
+	for (size_t i = 0; i < tokens->Count; i++)
+	{
+		const URCL_LineToken* token = &(tokens->Tokens[i]);
+		if (!URCL_TryCheckParserLimit(parser, token->Length, parser->Limits.MaxTokenLength, URCL_Error_TokenTooLong, source + token->Offset, token->Length)) return false;
+	}
+
+	return true;
+}
+
+bool URCL_TryParseStatementTokens(URCL_Parser* parser, const URCL_Char* source, size_t length, const URCL_LineTokens* tokens, unsigned long* kind, URCL_InstructionInfo* instruction, URCL_LabelInfo* label, size_t* offset)
+{
+	*kind = URCL_StatementKind_None;
+	*offset = 0;
+
+	if (!URCL_TryCheckTokenLengths(parser, source, tokens)) return false;
+
+	URCL_Char first = tokens->Count > 0 ? source[tokens->Tokens[0].Offset] : 0;
+	bool parsed = false;
+
+	if (first == '.')
+	{
+		parsed = URCL_TryParseLabelTokens(parser, source, tokens, label);
+		if (parsed) *kind = URCL_StatementKind_Label;
+	}
+	else if ((first == '@') && (parser->Defines != 0) && (URCL_GetDefineKeywordLength(source + tokens->Tokens[0].Offset, tokens->Tokens[0].Length) != 0))
+	{
+		parsed = URCL_TryParseDefineTokens(parser, source, length, tokens);
+		if (!parsed) return false;
+	}
+	else
+	{
+		if (first == '@') parsed = URCL_TryParseMacroInstructionTokens(parser, source, tokens, instruction);
+		else parsed = URCL_TryParseInstructionTokens(parser, source, length, tokens, instruction);
+
+		if (parsed) *kind = URCL_IsInstructionHeader(instruction) ? URCL_StatementKind_Header : URCL_StatementKind_Instruction;
+	}
+
+	if (parsed)
+	{
+		*offset = tokens->Length;
+	}
+	else if (parser->Error.Message == URCL_Error_ExpectedOperation)
+	{
+		URCL_ResetParserError(parser);
+		*offset = URCL_GetLineLength(source, length);
+	}
+	else
+	{
+		if (!URCL_ParserHasError(parser)) URCL_SetParserError(parser, URCL_Error_InvalidLine, source, URCL_GetLineLength(source, length));
+		return false;
+	}
+
+	return true;
+}
+
+////description Represents a function that receives each word of a DW array. The handler takes ownership of the word's string. Returns true to continue parsing or false to stop.
+typedef bool (*URCL_DataWordHandler)(URCL_Parser* parser, void* data, URCL_OperandInfo* word, const URCL_Char* position);
+
+bool URCL_IsDataArray(const URCL_Char* source, const URCL_LineTokens* tokens)
+{
+	if ((tokens->Count < 2) || (tokens->Tokens[0].Kind != URCL_LineTokenKind_Word) || (tokens->Tokens[1].Kind != URCL_LineTokenKind_Word)) return false;
+
+	return (source[tokens->Tokens[1].Offset] == '[') && (URCL_GetOpcode(source + tokens->Tokens[0].Offset, tokens->Tokens[0].Length) == URCL_Opcode_Dw);
+}
+
+size_t URCL_GetDataWordLength(const URCL_Char* value, size_t length)
+{
+	size_t result = URCL_GetOperandLength(value, length);
+
+	for (size_t i = 0; i < result; i++)
+	{
+		if (value[i] == ']') return i;
+	}
+
+	return result;
+}
+
+void URCL_InitDataInstruction(URCL_InstructionInfo* instruction, const URCL_OperandInfo* word)
+{
+	instruction->Operation = (URCL_Char*)URCL_OpcodeNames[URCL_Opcode_Dw];
+	instruction->OperationLength = URCL_OpcodeNameLengths[URCL_Opcode_Dw];
+	instruction->IsSourceView = true;
+	instruction->Opcode = URCL_Opcode_Dw;
+	instruction->Operands[0] = *word;
+
+	for (size_t i = 1; i < URCL_MaxOperands; i++)
+	{
+		instruction->Operands[i].Type = URCL_OperandType_None;
+		instruction->Operands[i].ImmediateValue = 0;
+		instruction->Operands[i].StringValue = 0;
+		instruction->Operands[i].StringLength = 0;
+		instruction->Operands[i].IsSourceView = false;
+	}
+}
+
+bool URCL_TryParseDataArray(URCL_Parser* parser, const URCL_Char* source, size_t length, const URCL_LineTokens* tokens, URCL_DataWordHandler onWord, void* data, size_t* offset)
+{
+	URCL_ResetParserError(parser);
+	size_t i = tokens->Tokens[1].Offset + 1;
+
+	while (true)
+	{
+		i += URCL_GetWhitespaceLength(source + i, length - i, false);
+
+		if ((i == length) || (source[i] == '\n'))
+		{
+			URCL_SetParserError(parser, URCL_Error_ExpectedArrayEnd, source + i, 0);
+			return false;
+		}
+
+		size_t commentLength = URCL_GetCommentLength(source + i, length - i);
+		if (commentLength != 0)
+		{
+			i += commentLength;
+			continue;
+		}
+
+		if (source[i] == ']')
+		{
+			i++;
+			break;
+		}
+
+		if (source[i] == ',')
+		{
+			i++;
+			continue;
+		}
+
+		size_t wordLength = URCL_GetDataWordLength(source + i, length - i);
+		size_t operandLength = 0;
+		URCL_OperandInfo word;
+
+		if (!URCL_TryCheckParserLimit(parser, wordLength, parser->Limits.MaxTokenLength, URCL_Error_TokenTooLong, source + i, wordLength)) return false;
+		if (!URCL_TryParseOperandWithWidth(parser, source + i, wordLength, true, &word, &operandLength)) return false;
+		if (!onWord(parser, data, &word, source + i)) return false;
+
+		i += wordLength;
+	}
+
+	URCL_LineTokens rest;
+	URCL_TokenizeLine(source + i, length - i, &rest);
+
+	if (rest.Count != 0)
+	{
+		URCL_SetParserError(parser, URCL_Error_InvalidLine, source + i + rest.Tokens[0].Offset, rest.Tokens[0].Length);
+		return false;
+	}
+
+	*offset = i + rest.Length;
+	return true;
+}
+
+size_t URCL_GetStatementEnd(const URCL_Char* source, size_t length, size_t offset)
+{
+	if ((offset < length) && (source[offset] == '\n')) offset++;
+	return offset;
+}
+
+bool URCL_TryAddLineStart(URCL_Parser* parser, URCL_LineIndex* lines, size_t* capacity, size_t offset)
+{
+	if (!URCL_TryReserveParserArray(parser, (void**)&(lines->LineStarts), capacity, lines->LineCount + 1, sizeof(size_t))) return false;
+
+	lines->LineStarts[lines->LineCount++] = offset;
+	return true;
+}
+
+bool URCL_TryBuildParserLineIndex(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_LineIndex* result)
+{
+	size_t capacity = 0;
+	URCL_InitLineIndex(result);
+
+	bool built = URCL_TryAddLineStart(parser, result, &capacity, 0);
+	size_t i = 0;
+
+	for (; built && ((length - i) >= URCL_ScanLanes); i += URCL_ScanLanes)
+	{
+		if (URCL_ScanEqualLanes(source + i, '\n') == 0) continue;
+
+		for (size_t j = i; built && (j < (i + URCL_ScanLanes)); j++)
+		{
+			if (source[j] == '\n') built = URCL_TryAddLineStart(parser, result, &capacity, j + 1);
+		}
+	}
+
+	for (; built && (i < length); i++)
+	{
+		if (source[i] == '\n') built = URCL_TryAddLineStart(parser, result, &capacity, i + 1);
+	}
+
+	if (!built) URCL_FreeLineIndex(result);
+	return built;
+}
+
+////description Attempts to build the line index of the specified source string in a single pass. Returns true if successful or false if out of memory, leaving the index empty. The index is freed with URCL_FreeLineIndex.
+bool URCL_TryBuildLineIndex(const URCL_Char* source, size_t length, URCL_LineIndex* result)
+{
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	return URCL_TryBuildParserLineIndex(&parser, source, length, result);
+}
+
+void URCL_WriteSourceMapNumber(unsigned char* data, size_t* offset, size_t value)
+{
+	for (; value >= 0x80; value >>= 7) data[(*offset)++] = (unsigned char)(value | 0x80);
+	data[(*offset)++] = (unsigned char)value;
+}
+
+bool URCL_TryAddSourceMapEntry(URCL_Parser* parser, URCL_SourceMap* map, size_t offset)
+{
+	size_t line = map->LastLine;
+	while (((line + 1) < map->Lines.LineCount) && (map->Lines.LineStarts[line + 1] <= offset)) line++;
+
+	if ((map->Count % URCL_SourceMapStride) == 0)
+	{
+		size_t checkpoint = map->Count / URCL_SourceMapStride;
+		if (!URCL_TryReserveParserArray(parser, (void**)&(map->Checkpoints), &(map->CheckpointCapacity), checkpoint + 1, sizeof(URCL_SourceMapCheckpoint))) return false;
+
+		map->Checkpoints[checkpoint].Offset = map->DataLength;
+		map->Checkpoints[checkpoint].Line = map->LastLine;
+	}
+
+	if (!URCL_TryReserveParserArray(parser, (void**)&(map->Data), &(map->DataCapacity), map->DataLength + (2 * ((sizeof(size_t) * 8 + 6) / 7)), 1)) return false;
+
+	URCL_WriteSourceMapNumber(map->Data, &(map->DataLength), line - map->LastLine);
+	URCL_WriteSourceMapNumber(map->Data, &(map->DataLength), offset - map->Lines.LineStarts[line]);
+	map->LastLine = line;
+	map->Count++;
+	return true;
+}
+
+bool URCL_TryAddDataWord(URCL_Parser* parser, URCL_DataSegment* segment, unsigned long long word, bool extendsRange)
+{
+	if (!URCL_TryReserveParserArray(parser, (void**)&(segment->Words), &(segment->WordCapacity), segment->WordCount + 1, sizeof(unsigned long long))) return false;
+
+	if (!extendsRange)
+	{
+		if (!URCL_TryReserveParserArray(parser, (void**)&(segment->Ranges), &(segment->RangeCapacity), segment->RangeCount + 1, sizeof(URCL_DataRange))) return false;
+
+		segment->Ranges[segment->RangeCount].Start = segment->WordCount;
+		segment->Ranges[segment->RangeCount].Count = 0;
+		segment->RangeCount++;
+	}
+
+	segment->Words[segment->WordCount++] = word;
+	segment->Ranges[segment->RangeCount - 1].Count++;
+	return true;
+}
+
+////description Represents a function that receives each instruction or header parsed by URCL_TryParseSourceStream. The handler takes ownership of the instruction's strings. Returns true to continue parsing or false to stop.
+typedef bool (*URCL_InstructionHandler)(URCL_Parser* parser, void* data, URCL_InstructionInfo* instruction);
+////description Represents a function that receives each label parsed by URCL_TryParseSourceStream. The handler takes ownership of the label's name. Returns true to continue parsing or false to stop.
+typedef bool (*URCL_LabelHandler)(URCL_Parser* parser, void* data, URCL_LabelInfo* label);
+
+typedef struct URCL_SourceStream
+{
+	URCL_InstructionHandler OnInstruction;
+	void* Data;
+	const URCL_Char* Source;
+	size_t InstructionCount;
+	size_t LabelCount;
+	size_t HeaderCount;
+	unsigned long long Address;
+	bool IsDataOpen;
+	bool IsStopped;
+} URCL_SourceStream;
+
+bool URCL_TryEmitInstruction(URCL_Parser* parser, URCL_SourceStream* stream, URCL_InstructionInfo* instruction, const URCL_Char* position)
+{
+	URCL_DataSegment* segment = parser->DataSegment;
+	bool isDataWord = (segment != 0) && (instruction->Opcode == URCL_Opcode_Dw) && (instruction->Operands[0].Type == URCL_OperandType_Immediate) && (instruction->Operands[1].Type == URCL_OperandType_None);
+	bool extendsRange = stream->IsDataOpen && isDataWord;
+	stream->IsDataOpen = isDataWord;
+
+	if (!extendsRange && !URCL_TryCheckParserLimit(parser, stream->InstructionCount + 1, parser->Limits.MaxInstructions, URCL_Error_InstructionLimit, position, 0))
+	{
+		URCL_ReleaseInstructions(parser, instruction, 1);
+		return false;
+	}
+
+	if (isDataWord)
+	{
+		bool added = URCL_TryAddDataWord(parser, segment, instruction->Operands[0].ImmediateValue, extendsRange);
+		if (!instruction->Operands[0].IsSourceView) URCL_Release(parser, instruction->Operands[0].StringValue);
+
+		if (!added)
+		{
+			URCL_SetOutOfMemoryError(parser, position);
+			return false;
+		}
+
+		stream->Address++;
+		if (extendsRange) return true;
+
+		instruction->Operands[0].Type = URCL_OperandType_Data;
+		instruction->Operands[0].ImmediateValue = segment->RangeCount - 1;
+		instruction->Operands[0].StringValue = 0;
+		instruction->Operands[0].StringLength = 0;
+		instruction->Operands[0].IsSourceView = false;
+	}
+
+	if ((parser->SourceMap != 0) && !URCL_TryAddSourceMapEntry(parser, parser->SourceMap, (size_t)(position - stream->Source)))
+	{
+		URCL_ReleaseInstructions(parser, instruction, 1);
+		URCL_SetOutOfMemoryError(parser, position);
+		return false;
+	}
+
+	if (!isDataWord) stream->Address++;
+	stream->InstructionCount++;
+
+	if (stream->OnInstruction != 0) return stream->OnInstruction(parser, stream->Data, instruction);
+
+	URCL_ReleaseInstructions(parser, instruction, 1);
+	return true;
+}
+
+bool URCL_CheckDataWord(URCL_Parser* parser, void* data, URCL_OperandInfo* word, const URCL_Char* position)
+{
+	(void)data;
+	(void)position;
+	if (!word->IsSourceView) URCL_Release(parser, word->StringValue);
+	return true;
+}
+
+bool URCL_EmitDataWord(URCL_Parser* parser, void* data, URCL_OperandInfo* word, const URCL_Char* position)
+{
+	URCL_SourceStream* stream = (URCL_SourceStream*)data;
+	URCL_InstructionInfo instruction;
+	URCL_InitDataInstruction(&instruction, word);
+
+	stream->IsStopped = !URCL_TryEmitInstruction(parser, stream, &instruction, position);
+	return !stream->IsStopped;
+}
+
+////description Attempts to parse the specified source string using the specified parser, passing each instruction, label, and header to the specified handlers as soon as its line is parsed. Labels are given the address of the next instruction. Null handlers release the items they would receive. Returns true if the parsing finished successfully or false if it failed or a handler stopped it. A handler that returns false can report an error with URCL_SetParserError, and an error without a position is given the position of the current line. The parser only keeps the state of the current line, so memory use does not grow with the source if source views are used without an arena. If the parser has a source map, it is rebuilt with the line index of the source and the position of each instruction. A DW line with a bracketed array, such as DW [ 1 2 3 ], passes one DW instruction per word of the array, or a single data instruction per run of immediate words if the parser has a data segment. Label addresses count words rather than instructions, so a label after a run of N words is N past the address of the run's data instruction. If errors are collected, the words of an array before an invalid word are kept.
+bool URCL_TryParseSourceStream(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_InstructionHandler onInstruction, URCL_LabelHandler onLabel, URCL_InstructionHandler onHeader, void* data)
+{
+	URCL_SourceStream stream;
+	stream.OnInstruction = onInstruction;
+	stream.Data = data;
+	stream.Source = source;
+	stream.InstructionCount = 0;
+	stream.LabelCount = 0;
+	stream.HeaderCount = 0;
+	stream.Address = 0;
+	stream.IsDataOpen = false;
+	stream.IsStopped = false;
+
+	if (parser->DataSegment != 0) URCL_FreeDataSegment(parser->DataSegment);
+
+	if (parser->SourceMap != 0)
+	{
+		URCL_FreeSourceMap(parser->SourceMap);
+
+		if (!URCL_TryBuildParserLineIndex(parser, source, length, &(parser->SourceMap->Lines)))
+		{
+			URCL_SetOutOfMemoryError(parser, source);
+			return false;
+		}
+	}
+
+	while (length > 0)
+	{
+		bool handled = true;
+		bool parsed = false;
+		unsigned long kind = URCL_StatementKind_None;
+		size_t offset = 0;
+		URCL_LabelInfo label;
+		URCL_InstructionInfo instruction;
+
+		URCL_LineTokens tokens;
+		URCL_TokenizeLine(source, length, &tokens);
+
+		if (URCL_IsDataArray(source, &tokens))
+		{
+			parsed = (parser->Errors == 0) || URCL_TryParseDataArray(parser, source, length, &tokens, URCL_CheckDataWord, 0, &offset);
+			if (parsed) parsed = URCL_TryParseDataArray(parser, source, length, &tokens, URCL_EmitDataWord, &stream, &offset);
+		}
+		else parsed = URCL_TryParseStatementTokens(parser, source, length, &tokens, &kind, &instruction, &label, &offset);
+
+		if (stream.IsStopped)
+		{
+			handled = false;
+		}
+		else if (!parsed)
+		{
+			if (!URCL_TryCollectParserError(parser)) return false;
+
+			offset = URCL_GetLineLength(source, length);
+		}
+		else if (kind == URCL_StatementKind_Label)
+		{
+			label.Address = stream.Address;
+			stream.IsDataOpen = false;
+			stream.LabelCount++;
+			handled = URCL_TryCheckParserLimit(parser, stream.LabelCount, parser->Limits.MaxLabels, URCL_Error_LabelLimit, source + tokens.Tokens[0].Offset, tokens.Tokens[0].Length);
+
+			if (handled && (onLabel != 0)) handled = onLabel(parser, data, &label);
+			else URCL_ReleaseLabels(parser, &label, 1);
+		}
+		else if (kind == URCL_StatementKind_Header)
+		{
+			stream.HeaderCount++;
+			handled = URCL_TryCheckParserLimit(parser, stream.HeaderCount, parser->Limits.MaxHeaders, URCL_Error_HeaderLimit, source + tokens.Tokens[0].Offset, tokens.Tokens[0].Length);
+
+			if (handled && (onHeader != 0)) handled = onHeader(parser, data, &instruction);
+			else URCL_ReleaseInstructions(parser, &instruction, 1);
+		}
+		else if (kind == URCL_StatementKind_Instruction)
+		{
+			handled = URCL_TryEmitInstruction(parser, &stream, &instruction, source + tokens.Tokens[0].Offset);
+		}
+
+		if (!handled)
+		{
+			if (!URCL_ParserHasError(parser)) URCL_SetParserError(parser, URCL_Error_StoppedByHandler, source, offset);
+			else if (parser->Error.Position == 0) URCL_SetParserError(parser, parser->Error.Message, source, offset);
+			return false;
+		}
+
+		offset = URCL_GetStatementEnd(source, length, offset);
+		source += offset;
+		length -= offset;
+	}
+
+	return true;
+}
+
+typedef struct URCL_SourceArrays
+{
+	URCL_InstructionInfo* Instructions;
+	URCL_LabelInfo* Labels;
+	URCL_InstructionInfo* Headers;
+	size_t InstructionCount;
+	size_t LabelCount;
+	size_t HeaderCount;
+	size_t InstructionCapacity;
+	size_t LabelCapacity;
+	size_t HeaderCapacity;
+} URCL_SourceArrays;
+
+bool URCL_TryAddArrayItem(URCL_Parser* parser, void** items, size_t* count, size_t* capacity, size_t itemSize)
+{
+	(*count)++;
+
+	if (*count == *capacity)
+	{
+		void* resized = URCL_Reallocate(parser, *items, *capacity * itemSize, *capacity * 2 * itemSize);
+		if (resized == 0)
+		{
+			URCL_SetOutOfMemoryError(parser, 0);
+			return false;
+		}
+
+		*items = resized;
+		*capacity *= 2;
+	}
+
+	return true;
+}
+
+bool URCL_AppendInstruction(URCL_Parser* parser, void* data, URCL_InstructionInfo* instruction)
+{
+	URCL_SourceArrays* arrays = (URCL_SourceArrays*)data;
+	arrays->Instructions[arrays->InstructionCount] = *instruction;
+	return URCL_TryAddArrayItem(parser, (void**)&(arrays->Instructions), &(arrays->InstructionCount), &(arrays->InstructionCapacity), sizeof(URCL_InstructionInfo));
+}
+
+bool URCL_AppendLabel(URCL_Parser* parser, void* data, URCL_LabelInfo* label)
+{
+	URCL_SourceArrays* arrays = (URCL_SourceArrays*)data;
+	arrays->Labels[arrays->LabelCount] = *label;
+	return URCL_TryAddArrayItem(parser, (void**)&(arrays->Labels), &(arrays->LabelCount), &(arrays->LabelCapacity), sizeof(URCL_LabelInfo));
+}
+
+bool URCL_AppendHeader(URCL_Parser* parser, void* data, URCL_InstructionInfo* header)
+{
+	URCL_SourceArrays* arrays = (URCL_SourceArrays*)data;
+	arrays->Headers[arrays->HeaderCount] = *header;
+	return URCL_TryAddArrayItem(parser, (void**)&(arrays->Headers), &(arrays->HeaderCount), &(arrays->HeaderCapacity), sizeof(URCL_InstructionInfo));
+}
+
+void* URCL_ShrinkArray(URCL_Parser* parser, void* items, size_t count, size_t capacity, size_t itemSize)
+{
+	if (count == 0) return items;
+
+	void* shrunk = URCL_Reallocate(parser, items, capacity * itemSize, count * itemSize);
+	return shrunk != 0 ? shrunk : items;
+}
+
+bool URCL_TryParseSourceArrays(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+	URCL_SourceArrays arrays;
+	arrays.InstructionCount = 0;
+	arrays.LabelCount = 0;
+	arrays.HeaderCount = 0;
+	arrays.InstructionCapacity = 1;
+	arrays.LabelCapacity = 1;
+	arrays.HeaderCapacity = 1;
+	arrays.Instructions = (URCL_InstructionInfo*)URCL_Allocate(parser, arrays.InstructionCapacity * sizeof(URCL_InstructionInfo));
+	arrays.Labels = (URCL_LabelInfo*)URCL_Allocate(parser, arrays.LabelCapacity * sizeof(URCL_LabelInfo));
+	arrays.Headers = (URCL_InstructionInfo*)URCL_Allocate(parser, arrays.HeaderCapacity * sizeof(URCL_InstructionInfo));
+
+	bool parsed = (arrays.Instructions != 0) && (arrays.Labels != 0) && (arrays.Headers != 0);
+	if (!parsed) URCL_SetOutOfMemoryError(parser, source);
+	else parsed = URCL_TryParseSourceStream(parser, source, length, URCL_AppendInstruction, URCL_AppendLabel, URCL_AppendHeader, &arrays);
+
+	if (!parsed)
+	{
+		URCL_ReleaseInstructions(parser, arrays.Instructions, arrays.InstructionCount);
+		URCL_ReleaseLabels(parser, arrays.Labels, arrays.LabelCount);
+		URCL_ReleaseInstructions(parser, arrays.Headers, arrays.HeaderCount);
+		URCL_Release(parser, arrays.Instructions);
+		URCL_Release(parser, arrays.Labels);
+		URCL_Release(parser, arrays.Headers);
+		return false;
+	}
+
+	*instructions = (URCL_InstructionInfo*)URCL_ShrinkArray(parser, arrays.Instructions, arrays.InstructionCount, arrays.InstructionCapacity, sizeof(URCL_InstructionInfo));
+	*labels = (URCL_LabelInfo*)URCL_ShrinkArray(parser, arrays.Labels, arrays.LabelCount, arrays.LabelCapacity, sizeof(URCL_LabelInfo));
+	*headers = (URCL_InstructionInfo*)URCL_ShrinkArray(parser, arrays.Headers, arrays.HeaderCount, arrays.HeaderCapacity, sizeof(URCL_InstructionInfo));
+	*instructionCount = arrays.InstructionCount;
+	*labelCount = arrays.LabelCount;
+	*headerCount = arrays.HeaderCount;
+	return true;
+}
+
+#ifdef URCL_Files
+bool URCL_TryParseCachedSource(URCL_Parser* parser, const URCL_Char* source, size_t length, size_t chunkCount, void (*runner)(void* data, void (*task)(void* context, size_t index), void* context, size_t count), void* runnerData, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount);
+#endif
+
+////description Attempts to parse the specified source string into instructions, labels, and headers using the specified parser. Returns true if the parsing finished successfully or false otherwise. Instruction, label, and header arrays are only valid if the result is true. If the parser has an arena, every array and string is allocated from it and any partial results remain in it on failure. If the parser has a cache directory, the results are read from the cache when the same source was parsed before with the same settings.
+bool URCL_TryParseSourceEx(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+#ifdef URCL_Files
+	if (parser->CacheDirectory != 0) return URCL_TryParseCachedSource(parser, source, length, 1, 0, 0, instructions, labels, headers, instructionCount, labelCount, headerCount);
+#endif
+	return URCL_TryParseSourceArrays(parser, source, length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+}
+
+////description Attempts to parse the specified source string into instructions, labels, and headers using the global parser settings. Returns true if the parsing finished successfully or false otherwise. Instruction, label, and header arrays are only valid if the result is true.
+bool URCL_TryParseSource(const URCL_Char* source, size_t length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	bool returnValue = URCL_TryParseSourceEx(&parser, source, length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+////description Attempts to parse the specified source string like URCL_TryParseSource, allocating every array and string from the specified arena. The results are released by freeing the arena instead of freeing each instruction and label. On failure, any partial results remain in the arena until it is freed.
+bool URCL_TryParseSourceWithArena(URCL_Arena* arena, const URCL_Char* source, size_t length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	parser.Arena = arena;
+	bool returnValue = URCL_TryParseSourceEx(&parser, source, length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+bool URCL_IsSkimmedInstruction(const URCL_Char* source, const URCL_LineTokens* tokens)
+{
+	if ((tokens->Count == 0) || tokens->IsTruncated || (tokens->Tokens[0].Kind != URCL_LineTokenKind_Word)) return false;
+
+	const URCL_Char* operation = source + tokens->Tokens[0].Offset;
+	return (operation[0] != '.') && (operation[0] != '@') && !URCL_IsInstructionHeaderName(operation, tokens->Tokens[0].Length);
+}
+
+bool URCL_CountDataWord(URCL_Parser* parser, void* data, URCL_OperandInfo* word, const URCL_Char* position)
+{
+	(void)position;
+	if (!word->IsSourceView) URCL_Release(parser, word->StringValue);
+	((URCL_SourceArrays*)data)->InstructionCount++;
+	return true;
+}
+
+bool URCL_TrySkimSourceArrays(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_SourceArrays* arrays)
+{
+	while (length > 0)
+	{
+		bool added = true;
+		bool parsed = true;
+		unsigned long kind = URCL_StatementKind_None;
+		size_t offset = 0;
+		URCL_LabelInfo label;
+		URCL_InstructionInfo instruction;
+
+		URCL_LineTokens tokens;
+		URCL_TokenizeLine(source, length, &tokens);
+
+		if (URCL_IsDataArray(source, &tokens))
+		{
+			size_t instructionCount = arrays->InstructionCount;
+			parsed = URCL_TryParseDataArray(parser, source, length, &tokens, URCL_CountDataWord, arrays, &offset);
+			if (!parsed) arrays->InstructionCount = instructionCount;
+		}
+		else if (URCL_IsSkimmedInstruction(source, &tokens))
+		{
+			parsed = URCL_TryCheckTokenLengths(parser, source, &tokens);
+			arrays->InstructionCount++;
+			offset = tokens.Length;
+		}
+		else
+		{
+			parsed = URCL_TryParseStatementTokens(parser, source, length, &tokens, &kind, &instruction, &label, &offset);
+		}
+
+		if (!parsed)
+		{
+			if (!URCL_TryCollectParserError(parser)) return false;
+
+			offset = URCL_GetLineLength(source, length);
+		}
+		else if (kind == URCL_StatementKind_Label)
+		{
+			label.Address = arrays->InstructionCount;
+			added = URCL_AppendLabel(parser, arrays, &label);
+		}
+		else if (kind == URCL_StatementKind_Header)
+		{
+			added = URCL_AppendHeader(parser, arrays, &instruction);
+		}
+		else if (kind == URCL_StatementKind_Instruction)
+		{
+			URCL_ReleaseInstructions(parser, &instruction, 1);
+			arrays->InstructionCount++;
+		}
+
+		if (added)
+		{
+			added = URCL_TryCheckParserLimit(parser, arrays->InstructionCount, parser->Limits.MaxInstructions, URCL_Error_InstructionLimit, source, offset) &&
+				URCL_TryCheckParserLimit(parser, arrays->LabelCount, parser->Limits.MaxLabels, URCL_Error_LabelLimit, source, offset) &&
+				URCL_TryCheckParserLimit(parser, arrays->HeaderCount, parser->Limits.MaxHeaders, URCL_Error_HeaderLimit, source, offset);
+		}
+
+		if (!added)
+		{
+			if (parser->Error.Position == 0) URCL_SetParserError(parser, parser->Error.Message, source, offset);
+			return false;
+		}
+
+		offset = URCL_GetStatementEnd(source, length, offset);
+		source += offset;
+		length -= offset;
+	}
+
+	return true;
+}
+
+////description Attempts to skim the specified source string using the specified parser, parsing only its labels, headers, and @DEFINE lines. Other lines are only tokenized and counted as instructions without parsing their operands, so an invalid instruction is counted instead of failing the parse. Each word of a DW array is counted as one instruction. Labels are given the same addresses as URCL_TryParseSourceEx gives them. Returns true if the skimming finished successfully or false otherwise. Label and header arrays and the instruction count are only valid if the result is true.
+bool URCL_TrySkimSourceEx(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* labelCount, size_t* headerCount, size_t* instructionCount)
+{
+	URCL_SourceArrays arrays;
+	arrays.Instructions = 0;
+	arrays.InstructionCount = 0;
+	arrays.LabelCount = 0;
+	arrays.HeaderCount = 0;
+	arrays.InstructionCapacity = 0;
+	arrays.LabelCapacity = 1;
+	arrays.HeaderCapacity = 1;
+	arrays.Labels = (URCL_LabelInfo*)URCL_Allocate(parser, arrays.LabelCapacity * sizeof(URCL_LabelInfo));
+	arrays.Headers = (URCL_InstructionInfo*)URCL_Allocate(parser, arrays.HeaderCapacity * sizeof(URCL_InstructionInfo));
+
+	bool skimmed = (arrays.Labels != 0) && (arrays.Headers != 0);
+	if (!skimmed) URCL_SetOutOfMemoryError(parser, source);
+	else skimmed = URCL_TrySkimSourceArrays(parser, source, length, &arrays);
+
+	if (!skimmed)
+	{
+		URCL_ReleaseLabels(parser, arrays.Labels, arrays.LabelCount);
+		URCL_ReleaseInstructions(parser, arrays.Headers, arrays.HeaderCount);
+		URCL_Release(parser, arrays.Labels);
+		URCL_Release(parser, arrays.Headers);
+		return false;
+	}
+
+	*labels = (URCL_LabelInfo*)URCL_ShrinkArray(parser, arrays.Labels, arrays.LabelCount, arrays.LabelCapacity, sizeof(URCL_LabelInfo));
+	*headers = (URCL_InstructionInfo*)URCL_ShrinkArray(parser, arrays.Headers, arrays.HeaderCount, arrays.HeaderCapacity, sizeof(URCL_InstructionInfo));
+	*labelCount = arrays.LabelCount;
+	*headerCount = arrays.HeaderCount;
+	*instructionCount = arrays.InstructionCount;
+	return true;
+}
+
+////description Attempts to skim the specified source string like URCL_TrySkimSourceEx using the global parser settings.
+bool URCL_TrySkimSource(const URCL_Char* source, size_t length, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* labelCount, size_t* headerCount, size_t* instructionCount)
+{
+	URCL_Parser parser;
+	URCL_InitParserFromGlobals(&parser);
+	bool returnValue = URCL_TrySkimSourceEx(&parser, source, length, labels, headers, labelCount, headerCount, instructionCount);
+	URCL_Error = parser.Error;
+	return returnValue;
+}
+
+////description Represents instructions or headers stored as parallel arrays with one row per item. Operand arrays hold URCL_MaxOperands entries per row, and strings are stored as offsets into the pool of the program columns.
+typedef struct URCL_InstructionColumns
+{
+	////class URCL_InstructionColumns
+	////description The number of rows.
+	size_t Count;
+	////class URCL_InstructionColumns
+	////description The opcode of each row.
+	unsigned long* Opcodes;
+	////class URCL_InstructionColumns
+	////description The pool offset of the operation of each row. The operation of a known opcode is not stored in the pool, and is found in URCL_OpcodeNames instead.
+	size_t* OperationOffsets;
+	////class URCL_InstructionColumns
+	////description The length of the operation of each row, or 0 if the opcode is known.
+	size_t* OperationLengths;
+	////class URCL_InstructionColumns
+	////description The type of each operand.
+	unsigned long* OperandTypes;
+	////class URCL_InstructionColumns
+	////description The numeric value of each operand.
+	unsigned long long* OperandValues;
+	////class URCL_InstructionColumns
+	////description The pool offset of the string value of each operand.
+	size_t* OperandOffsets;
+	////class URCL_InstructionColumns
+	////description The length of the string value of each operand, or 0 if the operand has no string value.
+	size_t* OperandLengths;
+} URCL_InstructionColumns;
+
+////description Represents parse results stored as parallel arrays instead of arrays of records, so that a pass over one field reads only that field. Every string is stored in a single pool.
+typedef struct URCL_ProgramColumns
+{
+	////class URCL_ProgramColumns
+	////description The parsed instructions in source order.
+	URCL_InstructionColumns Instructions;
+	////class URCL_ProgramColumns
+	////description The parsed headers in source order. Their arrays follow the instruction arrays in the same allocations.
+	URCL_InstructionColumns Headers;
+	////class URCL_ProgramColumns
+	////description The number of parsed labels.
+	size_t LabelCount;
+	////class URCL_ProgramColumns
+	////description The pool offset of the name of each label.
+	size_t* LabelOffsets;
+	////class URCL_ProgramColumns
+	////description The length of the name of each label.
+	size_t* LabelLengths;
+	////class URCL_ProgramColumns
+	////description The address of each label.
+	unsigned long long* LabelAddresses;
+	////class URCL_ProgramColumns
+	////description The characters of every string in the results.
+	URCL_Char* Pool;
+	////class URCL_ProgramColumns
+	////description The number of characters in the pool.
+	size_t PoolLength;
+} URCL_ProgramColumns;
+
+////description Frees every array of the specified program columns.
+void URCL_FreeProgramColumns(URCL_ProgramColumns* columns)
+{
+	URCL_free(columns->Instructions.Opcodes);
+	URCL_free(columns->Instructions.OperationOffsets);
+	URCL_free(columns->Instructions.OperationLengths);
+	URCL_free(columns->Instructions.OperandTypes);
+	URCL_free(columns->Instructions.OperandValues);
+	URCL_free(columns->Instructions.OperandOffsets);
+	URCL_free(columns->Instructions.OperandLengths);
+	URCL_free(columns->LabelOffsets);
+	URCL_free(columns->LabelLengths);
+	URCL_free(columns->LabelAddresses);
+	URCL_free(columns->Pool);
+}
+
+size_t URCL_CountLines(const URCL_Char* source, size_t length)
+{
+	size_t result = 1;
+	size_t i = 0;
+
+	for (; (length - i) >= URCL_ScanLanes; i += URCL_ScanLanes)
+	{
+		unsigned long long newLines = URCL_ScanEqualLanes(source + i, '\n');
+		for (; newLines != 0; newLines &= newLines - 1) result++;
+	}
+
+	for (; i < length; i++)
+	{
+		if (source[i] == '\n') result++;
+	}
+
+	return result;
+}
+
+typedef struct URCL_ColumnBuilder
+{
+	URCL_ProgramColumns* Columns;
+	size_t RowCapacity;
+	size_t PoolCapacity;
+} URCL_ColumnBuilder;
+
+bool URCL_TryAddColumnString(URCL_Parser* parser, URCL_ColumnBuilder* builder, const URCL_Char* value, size_t length, size_t* offset)
+{
+	URCL_ProgramColumns* columns = builder->Columns;
+	*offset = columns->PoolLength;
+
+	if ((builder->PoolCapacity - columns->PoolLength) < length)
+	{
+		size_t capacity = builder->PoolCapacity > 0 ? builder->PoolCapacity : 1;
+		while ((capacity - columns->PoolLength) < length) capacity *= 2;
+
+		URCL_Char* pool = URCL_TryChargeAllocation(parser, (capacity - builder->PoolCapacity) * sizeof(URCL_Char)) ? (URCL_Char*)URCL_realloc(columns->Pool, capacity * sizeof(URCL_Char)) : 0;
+		if (pool == 0)
+		{
+			URCL_SetOutOfMemoryError(parser, value);
+			return false;
+		}
+
+		columns->Pool = pool;
+		builder->PoolCapacity = capacity;
+	}
+
+	URCL_memcpy(columns->Pool + columns->PoolLength, value, length * sizeof(URCL_Char));
+	columns->PoolLength += length;
+	return true;
+}
+
+bool URCL_TryAddColumnRow(URCL_Parser* parser, URCL_ColumnBuilder* builder, size_t row, URCL_InstructionInfo* instruction)
+{
+	URCL_InstructionColumns* rows = &(builder->Columns->Instructions);
+	bool added = true;
+
+	rows->Opcodes[row] = instruction->Opcode;
+	rows->OperationOffsets[row] = 0;
+	rows->OperationLengths[row] = 0;
+	if (instruction->Opcode == URCL_Opcode_Unknown)
+	{
+		rows->OperationLengths[row] = instruction->OperationLength;
+		added = URCL_TryAddColumnString(parser, builder, instruction->Operation, instruction->OperationLength, &(rows->OperationOffsets[row]));
+	}
+
+	for (size_t i = 0; i < URCL_MaxOperands; i++)
+	{
+		URCL_OperandInfo* operand = &(instruction->Operands[i]);
+		size_t column = (row * URCL_MaxOperands) + i;
+		size_t stringLength = ((operand->Type != URCL_OperandType_None) && (operand->StringValue != 0)) ? operand->StringLength : 0;
+
+		rows->OperandTypes[column] = operand->Type;
+		rows->OperandValues[column] = operand->ImmediateValue;
+		rows->OperandOffsets[column] = 0;
+		rows->OperandLengths[column] = stringLength;
+		if (added && (stringLength > 0)) added = URCL_TryAddColumnString(parser, builder, operand->StringValue, stringLength, &(rows->OperandOffsets[column]));
+	}
+
+	URCL_ReleaseInstructions(parser, instruction, 1);
+	return added;
+}
+
+size_t URCL_GetColumnRowSize()
+{
+	return sizeof(unsigned long) + (2 * sizeof(size_t)) + (URCL_MaxOperands * (sizeof(unsigned long) + sizeof(unsigned long long) + (2 * sizeof(size_t)))) + (2 * sizeof(size_t)) + sizeof(unsigned long long);
+}
+
+bool URCL_TryGrowColumn(void** column, size_t itemSize, size_t capacity)
+{
+	void* grown = URCL_realloc(*column, capacity * itemSize);
+	if (grown == 0) return false;
+
+	*column = grown;
+	return true;
+}
+
+void URCL_MoveHeaderRows(void* column, size_t itemSize, size_t capacity, size_t newCapacity, size_t headerCount)
+{
+	char* data = (char*)column;
+	URCL_memmove(data + ((newCapacity - headerCount) * itemSize), data + ((capacity - headerCount) * itemSize), headerCount * itemSize);
+}
+
+bool URCL_TryReserveColumnRow(URCL_Parser* parser, URCL_ColumnBuilder* builder)
+{
+	URCL_ProgramColumns* columns = builder->Columns;
+	size_t capacity = builder->RowCapacity;
+	if ((columns->Instructions.Count + columns->Headers.Count + columns->LabelCount) < capacity) return true;
+
+	URCL_InstructionColumns* rows = &(columns->Instructions);
+	size_t newCapacity = capacity * 2;
+	bool grown = URCL_TryChargeAllocation(parser, capacity * URCL_GetColumnRowSize()) &&
+		URCL_TryGrowColumn((void**)&(rows->Opcodes), sizeof(unsigned long), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperationOffsets), sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperationLengths), sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperandTypes), URCL_MaxOperands * sizeof(unsigned long), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperandValues), URCL_MaxOperands * sizeof(unsigned long long), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperandOffsets), URCL_MaxOperands * sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(rows->OperandLengths), URCL_MaxOperands * sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(columns->LabelOffsets), sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(columns->LabelLengths), sizeof(size_t), newCapacity) &&
+		URCL_TryGrowColumn((void**)&(columns->LabelAddresses), sizeof(unsigned long long), newCapacity);
+
+	if (!grown)
+	{
+		URCL_SetOutOfMemoryError(parser, 0);
+		return false;
+	}
+
+	size_t headerCount = columns->Headers.Count;
+	URCL_MoveHeaderRows(rows->Opcodes, sizeof(unsigned long), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperationOffsets, sizeof(size_t), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperationLengths, sizeof(size_t), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperandTypes, URCL_MaxOperands * sizeof(unsigned long), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperandValues, URCL_MaxOperands * sizeof(unsigned long long), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperandOffsets, URCL_MaxOperands * sizeof(size_t), capacity, newCapacity, headerCount);
+	URCL_MoveHeaderRows(rows->OperandLengths, URCL_MaxOperands * sizeof(size_t), capacity, newCapacity, headerCount);
+
+	builder->RowCapacity = newCapacity;
+	return true;
+}
+
+bool URCL_AddInstructionColumns(URCL_Parser* parser, void* data, URCL_InstructionInfo* instruction)
+{
+	URCL_ColumnBuilder* builder = (URCL_ColumnBuilder*)data;
+	if (!URCL_TryReserveColumnRow(parser, builder))
+	{
+		URCL_ReleaseInstructions(parser, instruction, 1);
+		return false;
+	}
+
+	size_t row = builder->Columns->Instructions.Count;
+	builder->Columns->Instructions.Count++;
+	return URCL_TryAddColumnRow(parser, builder, row, instruction);
+}
+
+bool URCL_AddHeaderColumns(URCL_Parser* parser, void* data, URCL_InstructionInfo* header)
+{
+	URCL_ColumnBuilder* builder = (URCL_ColumnBuilder*)data;
+	if (!URCL_TryReserveColumnRow(parser, builder))
+	{
+		URCL_ReleaseInstructions(parser, header, 1);
+		return false;
+	}
+
+	builder->Columns->Headers.Count++;
+	return URCL_TryAddColumnRow(parser, builder, builder->RowCapacity - builder->Columns->Headers.Count, header);
+}
+
+bool URCL_AddLabelColumns(URCL_Parser* parser, void* data, URCL_LabelInfo* label)
+{
+	URCL_ColumnBuilder* builder = (URCL_ColumnBuilder*)data;
+	if (!URCL_TryReserveColumnRow(parser, builder))
+	{
+		URCL_ReleaseLabels(parser, label, 1);
+		return false;
+	}
+
+	URCL_ProgramColumns* columns = builder->Columns;
+	size_t index = columns->LabelCount;
+	columns->LabelCount++;
+
+	columns->LabelLengths[index] = label->NameLength;
+	columns->LabelAddresses[index] = label->Address;
+	bool added = URCL_TryAddColumnString(parser, builder, label->Name, label->NameLength, &(columns->LabelOffsets[index]));
+
+	URCL_ReleaseLabels(parser, label, 1);
+	return added;
+}
+
+void* URCL_FinishColumn(void* column, size_t itemSize, size_t capacity, size_t count, size_t headerCount)
+{
+	char* data = (char*)column;
+
+	for (size_t first = capacity - headerCount, last = capacity - 1; first < last; first++, last--)
+	{
+		for (size_t i = 0; i < itemSize; i++)
+		{
+			char swapped = data[(first * itemSize) + i];
+			data[(first * itemSize) + i] = data[(last * itemSize) + i];
+			data[(last * itemSize) + i] = swapped;
+		}
+	}
+
+	URCL_memmove(data + (count * itemSize), data + ((capacity - headerCount) * itemSize), headerCount * itemSize);
+
+	size_t rows = count + headerCount;
+	void* shrunk = URCL_realloc(column, (rows > 0 ? rows : 1) * itemSize);
+	return shrunk != 0 ? shrunk : column;
+}
+
+////description Attempts to parse the specified source string into program columns using the specified parser. Each array is allocated with one row per source line before parsing, grown only if DW arrays add more rows than there are lines, and shrunk to its final size afterwards. The arrays are always allocated with URCL_malloc, and the arena, cache directory, and source view settings of the parser are ignored. Returns true if successful or false otherwise. The columns are only valid if the result is true, and must be freed with URCL_FreeProgramColumns.
+bool URCL_TryParseSourceColumns(URCL_Parser* parser, const URCL_Char* source, size_t length, URCL_ProgramColumns* result)
+{
+	size_t rows = URCL_CountLines(source, length);
+
+	URCL_Parser viewParser = *parser;
+	viewParser.Arena = 0;
+	viewParser.SourceViews = true;
+	viewParser.CacheDirectory = 0;
+	URCL_ResetParserError(&viewParser);
+
+	if (!URCL_TryChargeAllocation(&viewParser, (rows * URCL_GetColumnRowSize()) + ((length > 0 ? length : 1) * sizeof(URCL_Char))))
+	{
+		URCL_SetOutOfMemoryError(&viewParser, source);
+		parser->Error = viewParser.Error;
+		parser->AllocatedBytes = viewParser.AllocatedBytes;
+		return false;
+	}
+
+	URCL_ProgramColumns columns;
+	columns.Instructions.Count = 0;
+	columns.Instructions.Opcodes = (unsigned long*)URCL_malloc(rows * sizeof(unsigned long));
+	columns.Instructions.OperationOffsets = (size_t*)URCL_malloc(rows * sizeof(size_t));
+	columns.Instructions.OperationLengths = (size_t*)URCL_malloc(rows * sizeof(size_t));
+	columns.Instructions.OperandTypes = (unsigned long*)URCL_malloc(rows * URCL_MaxOperands * sizeof(unsigned long));
+	columns.Instructions.OperandValues = (unsigned long long*)URCL_malloc(rows * URCL_MaxOperands * sizeof(unsigned long long));
+	columns.Instructions.OperandOffsets = (size_t*)URCL_malloc(rows * URCL_MaxOperands * sizeof(size_t));
+	columns.Instructions.OperandLengths = (size_t*)URCL_malloc(rows * URCL_MaxOperands * sizeof(size_t));
+	columns.Headers.Count = 0;
+	columns.LabelCount = 0;
+	columns.LabelOffsets = (size_t*)URCL_malloc(rows * sizeof(size_t));
+	columns.LabelLengths = (size_t*)URCL_malloc(rows * sizeof(size_t));
+	columns.LabelAddresses = (unsigned long long*)URCL_malloc(rows * sizeof(unsigned long long));
+	columns.Pool = (URCL_Char*)URCL_malloc((length > 0 ? length : 1) * sizeof(URCL_Char));
+	columns.PoolLength = 0;
+
+	URCL_ColumnBuilder builder;
+	builder.Columns = &columns;
+	builder.RowCapacity = rows;
+	builder.PoolCapacity = length > 0 ? length : 1;
+
+	bool parsed = (columns.Instructions.Opcodes != 0) && (columns.Instructions.OperationOffsets != 0) && (columns.Instructions.OperationLengths != 0) &&
+		(columns.Instructions.OperandTypes != 0) && (columns.Instructions.OperandValues != 0) && (columns.Instructions.OperandOffsets != 0) && (columns.Instructions.OperandLengths != 0) &&
+		(columns.LabelOffsets != 0) && (columns.LabelLengths != 0) && (columns.LabelAddresses != 0) && (columns.Pool != 0);
+
+	if (!parsed) URCL_SetOutOfMemoryError(&viewParser, source);
+	else parsed = URCL_TryParseSourceStream(&viewParser, source, length, URCL_AddInstructionColumns, URCL_AddLabelColumns, URCL_AddHeaderColumns, &builder);
+
+	parser->Error = viewParser.Error;
+	parser->ErrorCount = viewParser.ErrorCount;
+	parser->AllocatedBytes = viewParser.AllocatedBytes;
+
+	if (!parsed)
+	{
+		URCL_FreeProgramColumns(&columns);
+		return false;
+	}
+
+	rows = builder.RowCapacity;
+	size_t count = columns.Instructions.Count;
+	size_t headerCount = columns.Headers.Count;
+	columns.Instructions.Opcodes = (unsigned long*)URCL_FinishColumn(columns.Instructions.Opcodes, sizeof(unsigned long), rows, count, headerCount);
+	columns.Instructions.OperationOffsets = (size_t*)URCL_FinishColumn(columns.Instructions.OperationOffsets, sizeof(size_t), rows, count, headerCount);
+	columns.Instructions.OperationLengths = (size_t*)URCL_FinishColumn(columns.Instructions.OperationLengths, sizeof(size_t), rows, count, headerCount);
+	columns.Instructions.OperandTypes = (unsigned long*)URCL_FinishColumn(columns.Instructions.OperandTypes, URCL_MaxOperands * sizeof(unsigned long), rows, count, headerCount);
+	columns.Instructions.OperandValues = (unsigned long long*)URCL_FinishColumn(columns.Instructions.OperandValues, URCL_MaxOperands * sizeof(unsigned long long), rows, count, headerCount);
+	columns.Instructions.OperandOffsets = (size_t*)URCL_FinishColumn(columns.Instructions.OperandOffsets, URCL_MaxOperands * sizeof(size_t), rows, count, headerCount);
+	columns.Instructions.OperandLengths = (size_t*)URCL_FinishColumn(columns.Instructions.OperandLengths, URCL_MaxOperands * sizeof(size_t), rows, count, headerCount);
+
+	columns.Headers.Opcodes = columns.Instructions.Opcodes + count;
+	columns.Headers.OperationOffsets = columns.Instructions.OperationOffsets + count;
+	columns.Headers.OperationLengths = columns.Instructions.OperationLengths + count;
+	columns.Headers.OperandTypes = columns.Instructions.OperandTypes + (count * URCL_MaxOperands);
+	columns.Headers.OperandValues = columns.Instructions.OperandValues + (count * URCL_MaxOperands);
+	columns.Headers.OperandOffsets = columns.Instructions.OperandOffsets + (count * URCL_MaxOperands);
+	columns.Headers.OperandLengths = columns.Instructions.OperandLengths + (count * URCL_MaxOperands);
+
+	size_t labelRows = columns.LabelCount > 0 ? columns.LabelCount : 1;
+	void* shrunk = URCL_realloc(columns.LabelOffsets, labelRows * sizeof(size_t));
+	if (shrunk != 0) columns.LabelOffsets = (size_t*)shrunk;
+	shrunk = URCL_realloc(columns.LabelLengths, labelRows * sizeof(size_t));
+	if (shrunk != 0) columns.LabelLengths = (size_t*)shrunk;
+	shrunk = URCL_realloc(columns.LabelAddresses, labelRows * sizeof(unsigned long long));
+	if (shrunk != 0) columns.LabelAddresses = (unsigned long long*)shrunk;
+	shrunk = URCL_realloc(columns.Pool, (columns.PoolLength > 0 ? columns.PoolLength : 1) * sizeof(URCL_Char));
+	if (shrunk != 0) columns.Pool = (URCL_Char*)shrunk;
+
+	*result = columns;
+	return true;
+}
+
+////description Specifies the operation of an instruction or header.
+#define URCL_TokenKind_Operation 1
+////description Specifies an operand. The operand type of the token holds the type of the operand.
+#define URCL_TokenKind_Operand 2
+////description Specifies the name of a label definition.
+#define URCL_TokenKind_Label 3
+////description Specifies a macro, a @DEFINE keyword, or the name of a constant being defined.
+#define URCL_TokenKind_Macro 4
+////description Specifies a single-line or multi-line comment.
+#define URCL_TokenKind_Comment 5
+////description Specifies a comma between operands, or a bracket that opens or closes the words of a DW array.
+#define URCL_TokenKind_Separator 6
+
+////description Represents a span of source found by URCL_Lex.
+typedef struct URCL_Token
+{
+	////class URCL_Token
+	////description The kind of the token.
+	unsigned long Kind;
+	////class URCL_Token
+	////description The type of the operand if the token is an operand, or URCL_OperandType_None otherwise. The type is found from the operand text alone, so macros are not expanded and values are not checked against the target bits.
+	unsigned long OperandType;
+	////class URCL_Token
+	////description The offset of the first character of the token in the source.
+	size_t Offset;
+	////class URCL_Token
+	////description The number of characters in the token.
+	size_t Length;
+} URCL_Token;
+
+////description Represents the position of a lexer in a source. The lexer keeps no other state, so it can be started at the start of any line that is not inside a multi-line comment.
+typedef struct URCL_Lexer
+{
+	////class URCL_Lexer
+	////description The source being tokenized.
+	const URCL_Char* Source;
+	////class URCL_Lexer
+	////description The number of characters in the source.
+	size_t Length;
+	////class URCL_Lexer
+	////description The offset in the source where the next call to URCL_Lex continues.
+	size_t Offset;
+	////class URCL_Lexer
+	////description The number of words already found on the current line.
+	size_t WordCount;
+	////class URCL_Lexer
+	////description True if the current line starts with a @DEFINE keyword or false otherwise.
+	bool IsDefineLine;
+	////class URCL_Lexer
+	////description True if the current line starts with a DW operation or false otherwise.
+	bool IsDataLine;
+	////class URCL_Lexer
+	////description True if the lexer is between the brackets of a DW array on the current line or false otherwise.
+	bool IsInDataArray;
+} URCL_Lexer;
+
+////description Initializes a lexer that starts at the specified offset of the specified source. The offset must be the start of a line.
+void URCL_InitLexer(URCL_Lexer* lexer, const URCL_Char* source, size_t length, size_t offset)
+{
+	lexer->Source = source;
+	lexer->Length = length;
+	lexer->Offset = offset;
+	lexer->WordCount = 0;
+	lexer->IsDefineLine = false;
+	lexer->IsDataLine = false;
+	lexer->IsInDataArray = false;
+}
+
+unsigned long URCL_GetOperandTokenType(URCL_Parser* parser, const URCL_Char* value, size_t length)
+{
+	unsigned long long immediateValue = 0;
+	long long relativeValue = 0;
+	bool isSpecialRegister = false;
+	size_t resultLength = 0;
+
+	switch (value[0])
+	{
+		case '.':
+			return URCL_OperandType_Label;
+		case '%':
+			return URCL_OperandType_Port;
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			if (URCL_TryParseImmediate(parser, value, length, &immediateValue, &resultLength)) return URCL_OperandType_Immediate;
+			break;
+		case '~':
+			if (URCL_TryParseRelative(parser, value, length, &relativeValue, &resultLength)) return URCL_OperandType_Relative;
+			break;
+		case 'M':
+		case 'm':
+		case '#':
+			if (URCL_TryParseMemoryAddress(parser, value, length, &immediateValue, &resultLength)) return URCL_OperandType_MemoryAddress;
+			break;
+		default:
+			if (URCL_TryParseRegister(parser, value, length, &immediateValue, &isSpecialRegister, &resultLength)) return isSpecialRegister ? URCL_OperandType_SpecialRegister : URCL_OperandType_IndexedRegister;
+			break;
+	}
+
+	return URCL_OperandType_Any;
+}
+
+unsigned long URCL_GetWordTokenKind(URCL_Lexer* lexer, const URCL_Char* value, size_t length)
+{
+	if (lexer->WordCount == 0)
+	{
+		lexer->IsDefineLine = URCL_GetDefineKeywordLength(value, length) != 0;
+		lexer->IsDataLine = URCL_GetOpcode(value, length) == URCL_Opcode_Dw;
+
+		if (value[0] == '.') return URCL_TokenKind_Label;
+		else if (value[0] == '@') return URCL_TokenKind_Macro;
+		else return URCL_TokenKind_Operation;
+	}
+	else if ((value[0] == '@') || (lexer->IsDefineLine && (lexer->WordCount == 1)))
+	{
+		return URCL_TokenKind_Macro;
+	}
+	else
+	{
+		return URCL_TokenKind_Operand;
+	}
+}
+
+////description Finds the tokens that follow the position of the specified lexer, writing up to the specified capacity of tokens and advancing the lexer past them. Whitespace and line breaks are skipped, and every other character of the source belongs to exactly one token. No memory is allocated, so a tool can tokenize only the lines it displays by starting a lexer at the first of them. Returns the number of tokens written, which is 0 once the end of the source has been reached.
+size_t URCL_Lex(URCL_Lexer* lexer, URCL_Token* tokens, size_t capacity)
+{
+	const URCL_Char* source = lexer->Source;
+	size_t length = lexer->Length;
+	size_t count = 0;
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+
+	while ((count < capacity) && (lexer->Offset < length))
+	{
+		size_t offset = lexer->Offset + URCL_GetWhitespaceLength(source + lexer->Offset, length - lexer->Offset, false);
+		if (offset == length)
+		{
+			lexer->Offset = offset;
+			break;
+		}
+
+		if (source[offset] == '\n')
+		{
+			lexer->Offset = offset + 1;
+			lexer->WordCount = 0;
+			lexer->IsDefineLine = false;
+			lexer->IsDataLine = false;
+			lexer->IsInDataArray = false;
+			continue;
+		}
+
+		URCL_Token* token = &(tokens[count]);
+		token->Offset = offset;
+		token->OperandType = URCL_OperandType_None;
+		token->Length = URCL_GetCommentLength(source + offset, length - offset);
+
+		if (token->Length != 0)
+		{
+			token->Kind = URCL_TokenKind_Comment;
+		}
+		else if (source[offset] == ',')
+		{
+			token->Kind = URCL_TokenKind_Separator;
+			token->Length = 1;
+		}
+		else if (lexer->IsDataLine && (lexer->WordCount == 1) && (source[offset] == '['))
+		{
+			token->Kind = URCL_TokenKind_Separator;
+			token->Length = 1;
+			lexer->IsInDataArray = true;
+			lexer->WordCount++;
+		}
+		else if (lexer->IsInDataArray && (source[offset] == ']'))
+		{
+			token->Kind = URCL_TokenKind_Separator;
+			token->Length = 1;
+			lexer->IsInDataArray = false;
+		}
+		else
+		{
+			token->Length = lexer->IsInDataArray ? URCL_GetDataWordLength(source + offset, length - offset) : URCL_GetOperandLength(source + offset, length - offset);
+			token->Kind = URCL_GetWordTokenKind(lexer, source + offset, token->Length);
+			if (token->Kind == URCL_TokenKind_Operand) token->OperandType = URCL_GetOperandTokenType(&parser, source + offset, token->Length);
+			lexer->WordCount++;
+		}
+
+		lexer->Offset = offset + token->Length;
+		count++;
+	}
+
+	return count;
+}
+
+////description Represents a statement of a document, which is a line or a group of lines joined by a multi-line comment.
+typedef struct URCL_DocumentStatement
+{
+	////class URCL_DocumentStatement
+	////description The offset of the first character of the statement in the document source, without the pending shift of the document if the statement follows the last edit. URCL_GetDocumentStatementStart returns the current offset.
+	size_t Start;
+	////class URCL_DocumentStatement
+	////description The kind of item parsed from the statement: 0 for none, 1 for an instruction, 2 for a label, or 3 for a header.
+	unsigned long Kind;
+	////class URCL_DocumentStatement
+	////description The number of instructions parsed from the statement, which is one for an instruction statement unless it is a DW array with one instruction per word.
+	size_t InstructionCount;
+	////class URCL_DocumentStatement
+	////description True if the statement contains the start of a multi-line comment that is not closed, which makes its parse depend on every later character of the source.
+	bool IsCommentOpen;
+} URCL_DocumentStatement;
+
+////description Represents a source and its parse results that can be updated after each edit by reparsing only the statements the edit affects. Every string in the results is owned by the document.
+typedef struct URCL_Document
+{
+	////class URCL_Document
+	////description The parser used for the document. Its arena, source view, constant table, error list, source map, and data segment settings are ignored, and so are its allocation and count limits, but its macro depth and token length limits apply to each parsed line.
+	URCL_Parser Parser;
+	////class URCL_Document
+	////description The current source of the document.
+	URCL_Char* Source;
+	////class URCL_Document
+	////description The number of characters in the source.
+	size_t Length;
+	////class URCL_Document
+	////description The parsed instructions in source order.
+	URCL_InstructionInfo* Instructions;
+	////class URCL_Document
+	////description The parsed labels in source order. The addresses of labels after the last edit do not include its pending shift. URCL_GetDocumentLabelAddress returns the current address.
+	URCL_LabelInfo* Labels;
+	////class URCL_Document
+	////description The parsed headers in source order.
+	URCL_InstructionInfo* Headers;
+	////class URCL_Document
+	////description The number of parsed instructions.
+	size_t InstructionCount;
+	////class URCL_Document
+	////description The number of parsed labels.
+	size_t LabelCount;
+	////class URCL_Document
+	////description The number of parsed headers.
+	size_t HeaderCount;
+	////class URCL_Document
+	////description True if the parse results match the source, or false if the last parse failed.
+	bool IsParsed;
+	////class URCL_Document
+	////description The start and kind of every statement in the source.
+	URCL_DocumentStatement* Statements;
+	////class URCL_Document
+	////description The number of statements.
+	size_t StatementCount;
+	////class URCL_Document
+	////description The number of statements parsed by the last parse or edit, which is usually only the statements the edit touched.
+	size_t ParsedStatementCount;
+	////class URCL_Document
+	////description The index of the first statement whose comment is open, or the statement count if there is none. Every edit reparses from this statement at the latest.
+	size_t OpenStatement;
+	////class URCL_Document
+	////description The index of the first statement whose start does not include the pending shift of the last edit. The shift is moved past each statement on demand.
+	size_t ShiftStatement;
+	////class URCL_Document
+	////description The index of the first instruction of the statement at the pending shift.
+	size_t ShiftInstruction;
+	////class URCL_Document
+	////description The index of the first label whose address does not include the pending address shift.
+	size_t ShiftLabel;
+	////class URCL_Document
+	////description The index of the first header of the statement at the pending shift.
+	size_t ShiftHeader;
+	////class URCL_Document
+	////description The pending number of characters added to the start of every statement from the pending shift statement on. A shift that removes characters wraps around.
+	size_t StartShift;
+	////class URCL_Document
+	////description The pending number of instructions added to the address of every label from the pending shift label on. A shift that removes instructions wraps around.
+	unsigned long long AddressShift;
+	////class URCL_Document
+	////description The number of characters allocated for the source.
+	size_t SourceCapacity;
+	////class URCL_Document
+	////description The number of instructions allocated.
+	size_t InstructionCapacity;
+	////class URCL_Document
+	////description The number of labels allocated.
+	size_t LabelCapacity;
+	////class URCL_Document
+	////description The number of headers allocated.
+	size_t HeaderCapacity;
+	////class URCL_Document
+	////description The number of statements allocated.
+	size_t StatementCapacity;
+} URCL_Document;
+
+////description Initializes an empty document that is parsed with a copy of the specified parser.
+void URCL_InitDocument(URCL_Document* document, URCL_Parser* parser)
+{
+	document->Parser = *parser;
+	document->Parser.Arena = 0;
+	document->Parser.SourceViews = false;
+	document->Parser.Defines = 0;
+	document->Parser.Errors = 0;
+	document->Parser.ErrorCount = 0;
+	document->Parser.MaxErrors = 0;
+	document->Parser.SourceMap = 0;
+	document->Parser.DataSegment = 0;
+	document->Parser.Limits.MaxAllocatedBytes = 0;
+	document->Parser.Limits.MaxInstructions = 0;
+	document->Parser.Limits.MaxLabels = 0;
+	document->Parser.Limits.MaxHeaders = 0;
+	document->Source = 0;
+	document->Length = 0;
+	document->Instructions = 0;
+	document->Labels = 0;
+	document->Headers = 0;
+	document->InstructionCount = 0;
+	document->LabelCount = 0;
+	document->HeaderCount = 0;
+	document->IsParsed = true;
+	document->Statements = 0;
+	document->StatementCount = 0;
+	document->ParsedStatementCount = 0;
+	document->OpenStatement = 0;
+	document->ShiftStatement = 0;
+	document->ShiftInstruction = 0;
+	document->ShiftLabel = 0;
+	document->ShiftHeader = 0;
+	document->StartShift = 0;
+	document->AddressShift = 0;
+	document->SourceCapacity = 0;
+	document->InstructionCapacity = 0;
+	document->LabelCapacity = 0;
+	document->HeaderCapacity = 0;
+	document->StatementCapacity = 0;
+}
+
+void URCL_ReleaseDocumentResults(URCL_Document* document)
+{
+	URCL_FreeInstructions(document->Instructions, document->InstructionCount);
+	URCL_FreeLabels(document->Labels, document->LabelCount);
+	URCL_FreeInstructions(document->Headers, document->HeaderCount);
+	document->InstructionCount = 0;
+	document->LabelCount = 0;
+	document->HeaderCount = 0;
+	document->StatementCount = 0;
+	document->OpenStatement = 0;
+	document->ShiftStatement = 0;
+	document->ShiftInstruction = 0;
+	document->ShiftLabel = 0;
+	document->ShiftHeader = 0;
+	document->StartShift = 0;
+	document->AddressShift = 0;
+	document->IsParsed = false;
+}
+
+void URCL_MoveDocumentShift(URCL_Document* document, size_t index)
+{
+	for (; document->ShiftStatement < index; document->ShiftStatement++)
+	{
+		URCL_DocumentStatement* statement = &(document->Statements[document->ShiftStatement]);
+		statement->Start += document->StartShift;
+
+		if (statement->Kind == URCL_StatementKind_Instruction) document->ShiftInstruction += statement->InstructionCount;
+		else if (statement->Kind == URCL_StatementKind_Label) document->Labels[document->ShiftLabel++].Address += document->AddressShift;
+		else if (statement->Kind == URCL_StatementKind_Header) document->ShiftHeader++;
+	}
+
+	while (document->ShiftStatement > index)
+	{
+		URCL_DocumentStatement* statement = &(document->Statements[--document->ShiftStatement]);
+		statement->Start -= document->StartShift;
+
+		if (statement->Kind == URCL_StatementKind_Instruction) document->ShiftInstruction -= statement->InstructionCount;
+		else if (statement->Kind == URCL_StatementKind_Label) document->Labels[--document->ShiftLabel].Address -= document->AddressShift;
+		else if (statement->Kind == URCL_StatementKind_Header) document->ShiftHeader--;
+	}
+}
+
+////description Returns the current offset in the document source of the statement at the specified index.
+size_t URCL_GetDocumentStatementStart(URCL_Document* document, size_t index)
+{
+	return document->Statements[index].Start + ((index >= document->ShiftStatement) ? document->StartShift : 0);
+}
+
+////description Returns the current address of the label at the specified index of the document.
+unsigned long long URCL_GetDocumentLabelAddress(URCL_Document* document, size_t index)
+{
+	return document->Labels[index].Address + ((index >= document->ShiftLabel) ? document->AddressShift : 0);
+}
+
+////description Applies the pending shift of the specified document to every later statement start and label address, so that they can be read directly. This takes time proportional to the number of statements after the last edit.
+void URCL_ResolveDocumentPositions(URCL_Document* document)
+{
+	URCL_MoveDocumentShift(document, document->StatementCount);
+}
+
+////description Frees the source and parse results of the specified document.
+void URCL_FreeDocument(URCL_Document* document)
+{
+	URCL_ReleaseDocumentResults(document);
+	URCL_free(document->Source);
+	URCL_free(document->Instructions);
+	URCL_free(document->Labels);
+	URCL_free(document->Headers);
+	URCL_free(document->Statements);
+
+	URCL_Parser parser = document->Parser;
+	URCL_InitDocument(document, &parser);
+}
+
+void URCL_SpliceArray(void* items, size_t* count, size_t index, size_t removedCount, const void* inserted, size_t insertedCount, size_t itemSize)
+{
+	char* data = (char*)items;
+	URCL_memmove(data + ((index + insertedCount) * itemSize), data + ((index + removedCount) * itemSize), (*count - index - removedCount) * itemSize);
+	URCL_memcpy(data + (index * itemSize), inserted, insertedCount * itemSize);
+	*count = *count - removedCount + insertedCount;
+}
+
+bool URCL_TryEditDocumentSource(URCL_Document* document, size_t offset, size_t removedLength, const URCL_Char* inserted, size_t insertedLength)
+{
+	size_t length = document->Length - removedLength + insertedLength;
+
+	if (length > document->SourceCapacity)
+	{
+		size_t capacity = document->SourceCapacity > 0 ? document->SourceCapacity : 256;
+		while (capacity < length) capacity *= 2;
+
+		URCL_Char* resized = (URCL_Char*)URCL_realloc(document->Source, capacity * sizeof(URCL_Char));
+		if (resized == 0) return false;
+
+		document->Source = resized;
+		document->SourceCapacity = capacity;
+	}
+
+	URCL_Char* source = document->Source;
+	URCL_memmove(source + offset + insertedLength, source + offset + removedLength, (document->Length - offset - removedLength) * sizeof(URCL_Char));
+	URCL_memcpy(source + offset, inserted, insertedLength * sizeof(URCL_Char));
+	document->Length = length;
+	return true;
+}
+
+typedef struct URCL_DocumentRegion
+{
+	URCL_SourceArrays Arrays;
+	URCL_DocumentStatement* Statements;
+	size_t StatementCount;
+	size_t StatementCapacity;
+} URCL_DocumentRegion;
+
+void URCL_FreeDocumentRegion(URCL_DocumentRegion* region, bool releaseItems)
+{
+	if (releaseItems)
+	{
+		URCL_FreeInstructions(region->Arrays.Instructions, region->Arrays.InstructionCount);
+		URCL_FreeLabels(region->Arrays.Labels, region->Arrays.LabelCount);
+		URCL_FreeInstructions(region->Arrays.Headers, region->Arrays.HeaderCount);
+	}
+
+	URCL_free(region->Arrays.Instructions);
+	URCL_free(region->Arrays.Labels);
+	URCL_free(region->Arrays.Headers);
+	URCL_free(region->Statements);
+}
+
+bool URCL_HasOpenCommentToken(const URCL_Char* source, const URCL_LineTokens* tokens)
+{
+	for (size_t i = 0; i < tokens->Count; i++)
+	{
+		const URCL_LineToken* token = &(tokens->Tokens[i]);
+		if ((token->Kind == URCL_LineTokenKind_Word) && (token->Length >= 2) && (source[token->Offset] == '/') && (source[token->Offset + 1] == '*')) return true;
+	}
+	return false;
+}
+
+bool URCL_IsCommentOpen(const URCL_Char* source, size_t length)
+{
+	URCL_LineTokens tokens;
+	URCL_TokenizeLine(source, length, &tokens);
+	if (!URCL_IsDataArray(source, &tokens)) return URCL_HasOpenCommentToken(source, &tokens);
+
+	size_t i = tokens.Tokens[1].Offset + 1;
+	while (true)
+	{
+		i += URCL_GetWhitespaceLength(source + i, length - i, false);
+		if ((i == length) || (source[i] == '\n')) return false;
+
+		size_t commentLength = URCL_GetCommentLength(source + i, length - i);
+		if (commentLength != 0)
+		{
+			i += commentLength;
+			continue;
+		}
+
+		if (source[i] == ']')
 		{
-			if (value[result] == '*' && lastChar == '/') isInComment = true;
-			else if (value[result] == '\n') break;
+			URCL_LineTokens rest;
+			URCL_TokenizeLine(source + i + 1, length - i - 1, &rest);
+			return URCL_HasOpenCommentToken(source + i + 1, &rest);
 		}
-		lastChar = value[result];
-	}
 
-	return result;
+		size_t wordLength = (source[i] == ',') ? 1 : URCL_GetDataWordLength(source + i, length - i);
+		if ((wordLength >= 2) && (source[i] == '/') && (source[i + 1] == '*')) return true;
+		i += (wordLength != 0) ? wordLength : 1;
+	}
 }
 
-bool URCL_BasicMacroHandler(void* data, const URCL_Char* name, const URCL_Char* source, URCL_Char** result)
+bool URCL_AppendDataWord(URCL_Parser* parser, void* data, URCL_OperandInfo* word, const URCL_Char* position)
 {
-	unsigned long nameLength = 0;
-	for (; name[nameLength] != 0; nameLength++);
+	(void)position;
+	URCL_InstructionInfo instruction;
+	URCL_InitDataInstruction(&instruction, word);
+	return URCL_AppendInstruction(parser, data, &instruction);
+}
 
-	if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@MAX", 4))
+bool URCL_TryParseDocumentStatement(URCL_Document* document, URCL_DocumentRegion* region, size_t start, unsigned long long address, size_t* end)
+{
+	URCL_Parser* parser = &(document->Parser);
+	URCL_SourceArrays* arrays = &(region->Arrays);
+	const URCL_Char* source = document->Source + start;
+	size_t length = document->Length - start;
+	unsigned long kind = URCL_StatementKind_None;
+	size_t offset = 0;
+	size_t instructionCount = arrays->InstructionCount;
+	URCL_InstructionInfo instruction;
+	URCL_LabelInfo label;
+
+	URCL_LineTokens tokens;
+	URCL_TokenizeLine(source, length, &tokens);
+
+	bool added = true;
+	if (URCL_IsDataArray(source, &tokens))
+	{
+		if (!URCL_TryParseDataArray(parser, source, length, &tokens, URCL_AppendDataWord, arrays, &offset)) return false;
+		if (arrays->InstructionCount != instructionCount) kind = URCL_StatementKind_Instruction;
+	}
+	else if (!URCL_TryParseStatementTokens(parser, source, length, &tokens, &kind, &instruction, &label, &offset))
+	{
+		return false;
+	}
+	else if (kind == URCL_StatementKind_Label)
 	{
-		*result = URCL_ValueToString(URCL_GetMaxUnsignedValue(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		label.Address = address + arrays->InstructionCount;
+		added = URCL_AppendLabel(parser, arrays, &label);
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@SMAX", 5))
+	else if (kind == URCL_StatementKind_Instruction)
 	{
-		*result = URCL_ValueToString(URCL_GetMaxSignedValue(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		added = URCL_AppendInstruction(parser, arrays, &instruction);
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@MSB", 4))
+	else if (kind == URCL_StatementKind_Header)
 	{
-		*result = URCL_ValueToString(URCL_GetMostSignificantBit(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		added = URCL_AppendHeader(parser, arrays, &instruction);
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@SMSB", 5))
+
+	*end = start + URCL_GetStatementEnd(source, length, offset);
+
+	region->Statements[region->StatementCount].Start = start;
+	region->Statements[region->StatementCount].Kind = kind;
+	region->Statements[region->StatementCount].InstructionCount = arrays->InstructionCount - instructionCount;
+	region->Statements[region->StatementCount].IsCommentOpen = URCL_IsCommentOpen(source, *end - start);
+	added = added && URCL_TryAddArrayItem(parser, (void**)&(region->Statements), &(region->StatementCount), &(region->StatementCapacity), sizeof(URCL_DocumentStatement));
+
+	return added;
+}
+
+bool URCL_TryReparseDocument(URCL_Document* document, size_t editStart, size_t removedLength, size_t insertedLength)
+{
+	URCL_Parser* parser = &(document->Parser);
+	URCL_DocumentStatement* statements = document->Statements;
+	size_t statementCount = document->StatementCount;
+
+	size_t first = 0;
+	size_t last = statementCount;
+	while ((last - first) > 1)
 	{
-		*result = URCL_ValueToString(URCL_GetSecondMostSignificantBit(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		size_t middle = first + ((last - first) / 2);
+		if (URCL_GetDocumentStatementStart(document, middle) <= editStart) first = middle;
+		else last = middle;
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@LHALF", 6))
+	if (document->OpenStatement < first) first = document->OpenStatement;
+
+	URCL_MoveDocumentShift(document, first);
+	size_t instructionIndex = document->ShiftInstruction;
+	size_t labelIndex = document->ShiftLabel;
+	size_t headerIndex = document->ShiftHeader;
+	size_t startShift = document->StartShift;
+
+	URCL_DocumentRegion region;
+	region.Arrays.InstructionCount = 0;
+	region.Arrays.LabelCount = 0;
+	region.Arrays.HeaderCount = 0;
+	region.Arrays.InstructionCapacity = 1;
+	region.Arrays.LabelCapacity = 1;
+	region.Arrays.HeaderCapacity = 1;
+	region.Arrays.Instructions = (URCL_InstructionInfo*)URCL_malloc(sizeof(URCL_InstructionInfo));
+	region.Arrays.Labels = (URCL_LabelInfo*)URCL_malloc(sizeof(URCL_LabelInfo));
+	region.Arrays.Headers = (URCL_InstructionInfo*)URCL_malloc(sizeof(URCL_InstructionInfo));
+	region.StatementCount = 0;
+	region.StatementCapacity = 1;
+	region.Statements = (URCL_DocumentStatement*)URCL_malloc(sizeof(URCL_DocumentStatement));
+
+	URCL_ResetParserError(parser);
+	bool parsed = (region.Arrays.Instructions != 0) && (region.Arrays.Labels != 0) && (region.Arrays.Headers != 0) && (region.Statements != 0);
+	if (!parsed) URCL_SetOutOfMemoryError(parser, document->Source);
+
+	size_t editEnd = editStart + insertedLength;
+	size_t position = (first < statementCount) ? (statements[first].Start + startShift) : 0;
+	size_t next = first;
+
+	while (parsed && (position < document->Length))
 	{
-		*result = URCL_ValueToString(URCL_GetLowerBits(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		parsed = URCL_TryParseDocumentStatement(document, &region, position, instructionIndex, &position);
+
+		if (position >= editEnd)
+		{
+			while ((next < statementCount) && ((statements[next].Start + startShift + insertedLength) < (position + removedLength))) next++;
+			if ((next < statementCount) && ((statements[next].Start + startShift + insertedLength) == (position + removedLength)) && ((statements[next].Start + startShift) >= (editStart + removedLength))) break;
+		}
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@UHALF", 6))
+
+	if (position >= document->Length) next = statementCount;
+	document->ParsedStatementCount = region.StatementCount;
+
+	if (!parsed)
 	{
-		*result = URCL_ValueToString(URCL_GetUpperBits(URCL_TargetBits / 8));
-		return !URCL_HasError();
+		URCL_FreeDocumentRegion(&region, true);
+		URCL_ReleaseDocumentResults(document);
+		return false;
 	}
-	else if (URCL_IsStringEqualCaseInsensitive(name, nameLength, u"@BITS", 5))
+
+	size_t removedInstructions = 0;
+	size_t removedLabels = 0;
+	size_t removedHeaders = 0;
+	for (size_t i = first; i < next; i++)
 	{
-		*result = URCL_ValueToString(URCL_TargetBits);
-		return !URCL_HasError();
+		if (statements[i].Kind == URCL_StatementKind_Instruction) removedInstructions += statements[i].InstructionCount;
+		else if (statements[i].Kind == URCL_StatementKind_Label) removedLabels++;
+		else if (statements[i].Kind == URCL_StatementKind_Header) removedHeaders++;
 	}
-	else
+
+	bool reserved = URCL_TryReserveArray((void**)&(document->Instructions), &(document->InstructionCapacity), document->InstructionCount - removedInstructions + region.Arrays.InstructionCount, sizeof(URCL_InstructionInfo)) &&
+		URCL_TryReserveArray((void**)&(document->Labels), &(document->LabelCapacity), document->LabelCount - removedLabels + region.Arrays.LabelCount, sizeof(URCL_LabelInfo)) &&
+		URCL_TryReserveArray((void**)&(document->Headers), &(document->HeaderCapacity), document->HeaderCount - removedHeaders + region.Arrays.HeaderCount, sizeof(URCL_InstructionInfo)) &&
+		URCL_TryReserveArray((void**)&(document->Statements), &(document->StatementCapacity), statementCount - (next - first) + region.StatementCount, sizeof(URCL_DocumentStatement));
+
+	if (!reserved)
 	{
-		URCL_SetError(URCL_Error_UnknownMacro, source, nameLength);
+		URCL_SetOutOfMemoryError(parser, document->Source);
+		URCL_FreeDocumentRegion(&region, true);
+		URCL_ReleaseDocumentResults(document);
 		return false;
 	}
+
+	URCL_FreeInstructions(document->Instructions + instructionIndex, removedInstructions);
+	URCL_FreeLabels(document->Labels + labelIndex, removedLabels);
+	URCL_FreeInstructions(document->Headers + headerIndex, removedHeaders);
+
+	URCL_SpliceArray(document->Instructions, &(document->InstructionCount), instructionIndex, removedInstructions, region.Arrays.Instructions, region.Arrays.InstructionCount, sizeof(URCL_InstructionInfo));
+	URCL_SpliceArray(document->Labels, &(document->LabelCount), labelIndex, removedLabels, region.Arrays.Labels, region.Arrays.LabelCount, sizeof(URCL_LabelInfo));
+	URCL_SpliceArray(document->Headers, &(document->HeaderCount), headerIndex, removedHeaders, region.Arrays.Headers, region.Arrays.HeaderCount, sizeof(URCL_InstructionInfo));
+	URCL_SpliceArray(document->Statements, &(document->StatementCount), first, next - first, region.Statements, region.StatementCount, sizeof(URCL_DocumentStatement));
+
+	size_t openStatement = first;
+	while ((openStatement < (first + region.StatementCount)) && !document->Statements[openStatement].IsCommentOpen) openStatement++;
+	if ((openStatement == (first + region.StatementCount)) && (document->OpenStatement >= next)) openStatement = document->OpenStatement - (next - first) + region.StatementCount;
+	while ((openStatement < document->StatementCount) && !document->Statements[openStatement].IsCommentOpen) openStatement++;
+	document->OpenStatement = openStatement;
+
+	document->ShiftStatement = first + region.StatementCount;
+	document->ShiftInstruction = instructionIndex + region.Arrays.InstructionCount;
+	document->ShiftLabel = labelIndex + region.Arrays.LabelCount;
+	document->ShiftHeader = headerIndex + region.Arrays.HeaderCount;
+	document->StartShift = startShift + insertedLength - removedLength;
+	document->AddressShift = document->AddressShift + region.Arrays.InstructionCount - removedInstructions;
+
+	URCL_FreeDocumentRegion(&region, false);
+	return true;
 }
 
-bool URCL_InvokeMacroHandler(const URCL_Char* value, unsigned long length, URCL_Char** result)
+////description Attempts to replace the source of the specified document with a copy of the specified source and parse it entirely. Returns true if successful or false otherwise. The parse results are only valid if the result is true.
+bool URCL_TryParseDocument(URCL_Document* document, const URCL_Char* source, size_t length)
 {
-	URCL_Char* name = URCL_Substring(value, 0, URCL_GetOperandLength(value, length));
-	bool returnValue = URCL_MacroHandler(URCL_MacroHandlerData, name, value, result);
-	URCL_free(name);
-	return returnValue;
+	URCL_ReleaseDocumentResults(document);
+
+	if (!URCL_TryEditDocumentSource(document, 0, document->Length, source, length))
+	{
+		URCL_SetOutOfMemoryError(&(document->Parser), source);
+		return false;
+	}
+
+	document->IsParsed = URCL_TryReparseDocument(document, 0, 0, length);
+	return document->IsParsed;
 }
 
-bool URCL_TryParseOperandWithPrefix(URCL_Char prefix, const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
+////description Attempts to replace the specified number of characters at the specified offset of the document source with the specified inserted characters, and updates the parse results. Only the statements from the one containing the offset up to the first unchanged statement after the edit are parsed again, so a multi-line comment that is opened or closed by the edit is reparsed along with every statement it covers. Later statements and labels are not rewritten. The change in offsets and in the number of instructions is kept as one pending shift that the next edit moves to its own position, so an edit takes time proportional to the reparsed statements and the number of statements since the previous edit rather than to the size of the document. If the previous parse failed, the whole document is parsed again. Returns true if successful or false otherwise. The parse results are only valid if the result is true.
+bool URCL_TryEditDocument(URCL_Document* document, size_t offset, size_t removedLength, const URCL_Char* inserted, size_t insertedLength)
 {
-	if (length == 0 || value[0] != prefix)
+	URCL_ResetParserError(&(document->Parser));
+
+	if ((offset > document->Length) || (removedLength > (document->Length - offset)))
 	{
-		URCL_SetError(URCL_Error_MissingOperandPrefix, value, 1);
+		URCL_SetParserError(&(document->Parser), URCL_Error_InvalidEdit, inserted, insertedLength);
 		return false;
 	}
 
-	*resultLength = URCL_GetOperandLength(value, length);
-	*result = URCL_Substring(value, 0, *resultLength);
+	if (!URCL_TryEditDocumentSource(document, offset, removedLength, inserted, insertedLength))
+	{
+		URCL_SetOutOfMemoryError(&(document->Parser), inserted);
+		return false;
+	}
 
-	return *result != 0;
+	if (!document->IsParsed)
+	{
+		URCL_ReleaseDocumentResults(document);
+		document->IsParsed = URCL_TryReparseDocument(document, 0, 0, document->Length);
+	}
+	else
+	{
+		document->IsParsed = URCL_TryReparseDocument(document, offset, removedLength, insertedLength);
+	}
+
+	return document->IsParsed;
 }
 
-bool URCL_TryParseOperandWithPrefixes(const URCL_Char* prefixes, const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
+#ifdef URCL_Files
+////description The number of bytes read at a time from a file that cannot be memory-mapped.
+#define URCL_FileReadSize 65536
+
+////description Represents a source file opened for parsing. Parsed strings may be views into the file, so it must stay open until they are no longer used.
+typedef struct URCL_SourceFile
 {
-	for (unsigned long i = 0; prefixes[i] != 0; i++)
+	////class URCL_SourceFile
+	////description The characters of the file, excluding any byte order mark.
+	const URCL_Char* Source;
+	////class URCL_SourceFile
+	////description The number of characters in the source.
+	size_t Length;
+	////class URCL_SourceFile
+	////description The memory holding the contents of the file.
+	void* Data;
+	////class URCL_SourceFile
+	////description The number of bytes in the file.
+	size_t Size;
+	////class URCL_SourceFile
+	////description True if the file is memory-mapped or false if it was read into an allocated buffer.
+	bool IsMapped;
+} URCL_SourceFile;
+
+bool URCL_TryReadFileDescriptor(int descriptor, URCL_SourceFile* file)
+{
+	size_t capacity = URCL_FileReadSize;
+	char* data = (char*)URCL_malloc(capacity);
+	size_t size = 0;
+
+	while (data != 0)
 	{
-		if (URCL_TryParseOperandWithPrefix(prefixes[i], value, length, result, resultLength))
+		if (size == capacity)
 		{
-			URCL_ResetError();
-			return true;
+			char* resized = (char*)URCL_realloc(data, capacity * 2);
+			if (resized == 0) break;
+
+			data = resized;
+			capacity *= 2;
 		}
-		else
+
+		ssize_t count = read(descriptor, data + size, capacity - size);
+		if ((count < 0) && (errno == EINTR)) continue;
+		if (count < 0) break;
+
+		if (count == 0)
 		{
-			if (prefixes[i + 1] != 0) URCL_ResetError();
+			file->Data = data;
+			file->Size = size;
+			return true;
 		}
+
+		size += (size_t)count;
 	}
 
+	URCL_free(data);
 	return false;
 }
 
-bool URCL_TryParseAny(const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
+////description Closes the specified source file, releasing its memory. Closing a file that failed to open has no effect.
+void URCL_CloseSourceFile(URCL_SourceFile* file)
 {
-	*resultLength = URCL_GetOperandLength(value, length);
-	*result = URCL_Substring(value, 0, *resultLength);
-
-	return *result != 0;
+	if (file->IsMapped) munmap(file->Data, file->Size);
+	else URCL_free(file->Data);
+
+	file->Source = 0;
+	file->Length = 0;
+	file->Data = 0;
+	file->Size = 0;
+	file->IsMapped = false;
 }
 
-bool URCL_TryParseLabel(const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
+bool URCL_TryLoadFile(const char* path, URCL_SourceFile* file)
 {
-	return URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Label, value, length, result, resultLength);
-}
+	file->Source = 0;
+	file->Length = 0;
+	file->Data = 0;
+	file->Size = 0;
+	file->IsMapped = false;
 
-bool URCL_TryParsePort(const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
-{
-	return URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Port, value, length, result, resultLength);
-}
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) return false;
 
-bool URCL_TryParseImmediate(const URCL_Char* value, unsigned long length, unsigned long long* result, unsigned long* resultLength)
-{
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Immediate, value, length, &resultString, resultLength))
+	struct stat info;
+	if ((fstat(descriptor, &info) == 0) && S_ISREG(info.st_mode) && (info.st_size > 0) && ((unsigned long long)info.st_size <= (size_t)-1))
 	{
-		if (*resultLength > 2 && resultString[0] == '0' && !URCL_CharIsDigit(resultString[1]))
-		{
-			if (resultString[1] == 'x' || resultString[1] == 'X')
-			{
-				*result = 0;
-				for (unsigned long i = 2; i < *resultLength; i++)
-				{
-					if (resultString[i] >= '0' && resultString[i] <= '9')
-					{
-						*result = (*result << 4) | (resultString[i] - '0');
-					}
-					else if (resultString[i] >= 'A' && resultString[i] <= 'F')
-					{
-						*result = (*result << 4) | ((resultString[i] - 'A') + 10);
-					}
-					else if (resultString[i] >= 'a' && resultString[i] <= 'f')
-					{
-						*result = (*result << 4) | ((resultString[i] - 'a') + 10);
-					}
-					else
-					{
-						URCL_SetError(URCL_Error_UnexpectedHexChar, value + i, 1);
-						URCL_free(resultString);
-						return false;
-					}
-				}
-			}
-			else if (resultString[1] == 'o' || resultString[1] == 'O')
-			{
-				*result = 0;
-				for (unsigned long i = 2; i < *resultLength; i++)
-				{
-					if (resultString[i] >= '0' && resultString[i] <= '7')
-					{
-						*result = (*result << 3) | (resultString[i] - '0');
-					}
-					else
-					{
-						URCL_SetError(URCL_Error_UnexpectedOctChar, value + i, 1);
-						URCL_free(resultString);
-						return false;
-					}
-				}
-			}
-			else if (resultString[1] == 'b' || resultString[1] == 'B')
-			{
-				*result = 0;
-				for (unsigned long i = 2; i < *resultLength; i++)
-				{
-					if (resultString[i] >= '0' && resultString[i] <= '1')
-					{
-						*result = (*result << 1) | (resultString[i] == '1' ? 1 : 0);
-					}
-					else
-					{
-						URCL_SetError(URCL_Error_UnexpectedBinChar, value + i, 1);
-						URCL_free(resultString);
-						return false;
-					}
-				}
-			}
-			else
-			{
-				URCL_SetError(URCL_Error_UnknownImmTypePrefix, value + 1, 1);
-				URCL_free(resultString);
-				return false;
-			}
-		}
-		else
+		void* data = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (data != MAP_FAILED)
 		{
-			*result = 0;
-			for (unsigned long i = 0; i < *resultLength; i++)
-			{
-				if (resultString[i] >= '0' && resultString[i] <= '9')
-				{
-					*result = (*result * 10) + (resultString[i] - '0');
-				}
-				else
-				{
-					URCL_SetError(URCL_Error_UnexpectedDecChar, value + i, 1);
-					URCL_free(resultString);
-					return false;
-				}
-			}
+			file->Data = data;
+			file->Size = (size_t)info.st_size;
+			file->IsMapped = true;
 		}
-
-		URCL_free(resultString);
-		return true;
-	}
-	else
-	{
-		return false;
 	}
+
+	bool loaded = file->IsMapped || URCL_TryReadFileDescriptor(descriptor, file);
+	close(descriptor);
+	return loaded;
 }
 
-bool URCL_TryParseRelative(const URCL_Char* value, unsigned long length, long long* result, unsigned long* resultLength)
+////description Attempts to open the file at the specified path for parsing. Regular files are memory-mapped as read-only, and other files such as pipes are read to the end into an allocated buffer before the function returns, so the whole contents are held in memory at once. The contents are interpreted as URCL_Char values in native byte order. Returns true if successful or false otherwise.
+bool URCL_TryOpenSourceFile(URCL_Parser* parser, const char* path, URCL_SourceFile* file)
 {
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Relative, value, length, &resultString, resultLength))
+	if (!URCL_TryLoadFile(path, file))
 	{
-		if ((*resultLength > 2) || (*resultLength == 2 && URCL_CharIsDigit(resultString[1])))
-		{
-			unsigned long offset = 1;
-			bool negative = false;
-			
-			if (resultString[offset] == '-')
-			{
-				negative = true;
-				offset++;
-			}
-			else if (resultString[offset] == '+')
-			{
-				offset++;
-			}
-			else if (!URCL_CharIsDigit(resultString[offset]))
-			{
-				URCL_SetError(URCL_Error_UnexpectedRelativeChar, value + offset, 1);
-				URCL_free(resultString);
-				return false;
-			}
-
-			URCL_free(resultString);
-
-			unsigned long long immediateValue;
-			unsigned long immediateLength;
-			if (URCL_TryParseImmediate(value + offset, *resultLength - offset, &immediateValue, &immediateLength))
-			{
-				if (immediateValue > URCL_GetMaxSignedValue(sizeof(long long)))
-				{
-					URCL_SetError(URCL_Error_RelativeValueTooLarge, value + offset, *resultLength);
-					return false;
-				}
+		URCL_SetParserError(parser, URCL_Error_UnreadableFile, 0, 0);
+		return false;
+	}
 
-				if (negative) *result = -((long long)immediateValue);
-				else *result = (long long)immediateValue;
+	file->Source = (const URCL_Char*)file->Data;
+	file->Length = file->Size / sizeof(URCL_Char);
 
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else
-		{
-			URCL_SetError(URCL_Error_InvalidRelativeValue, value + 1, 1);
-			URCL_free(resultString);
-			return false;
-		}
+#ifdef URCL_Utf8
+	if ((file->Length >= 3) && (file->Source[0] == 0xEF) && (file->Source[1] == 0xBB) && (file->Source[2] == 0xBF))
+	{
+		file->Source += 3;
+		file->Length -= 3;
 	}
-	else
+#else
+	if ((file->Length >= 1) && (file->Source[0] == 0xFEFF))
 	{
-		return false;
+		file->Source++;
+		file->Length--;
 	}
+#endif
+
+	return true;
 }
 
-bool URCL_TryParseMemoryAddress(const URCL_Char* value, unsigned long length, unsigned long long* result, unsigned long* resultLength)
+////description Attempts to parse the file at the specified path into instructions, labels, and headers using the specified parser, without copying the file if it can be memory-mapped. A file that cannot be memory-mapped, such as a pipe, is read completely before parsing starts. The opened file is stored in the specified source file, which must be closed with URCL_CloseSourceFile after the results and any error position are no longer used, whether or not the parsing succeeded. Returns true if the parsing finished successfully or false otherwise.
+bool URCL_TryParseFile(URCL_Parser* parser, const char* path, URCL_SourceFile* file, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
 {
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Memory, value, length, &resultString, resultLength))
-	{
-		URCL_free(resultString);
+	if (!URCL_TryOpenSourceFile(parser, path, file)) return false;
+	return URCL_TryParseSourceEx(parser, file->Source, file->Length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+}
+#endif
 
-		if (*resultLength > 1)
-		{
-			unsigned long immediateLength;
-			return URCL_TryParseImmediate(value + 1, *resultLength - 1, result, &immediateLength);
-		}
-		else
-		{
-			URCL_SetError(URCL_Error_InvalidMemoryAddress, value + 1, 1);
-			return false;
-		}
-	}
-	else
-	{
-		return false;
-	}
+////description The minimum number of characters in each chunk when a source is split for a parallel parse.
+#define URCL_ParallelMinimumChunkLength 65536
+////description The number of chunks per thread when a source is split for a parallel parse, which balances the work between threads.
+#define URCL_ParallelChunksPerThread 4
+
+////description Represents a function that runs the tasks of a parallel parse. The runner must call the task once with each index from 0 to count - 1, may make the calls concurrently, and must return only after every call has returned.
+typedef void (*URCL_TaskRunner)(void* data, void (*task)(void* context, size_t index), void* context, size_t count);
+
+////description Runs each task in order on the calling thread.
+void URCL_RunTasksSequentially(void* data, void (*task)(void* context, size_t index), void* context, size_t count)
+{
+	(void)data;
+	for (size_t i = 0; i < count; i++) task(context, i);
 }
 
-bool URCL_TryParseRegister(const URCL_Char* value, unsigned long length, unsigned long long* result, bool* isSpecialRegister, unsigned long* resultLength)
+typedef struct URCL_SourceChunk
 {
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Register, value, length, &resultString, resultLength))
-	{
-		URCL_free(resultString);
+	size_t Start;
+	size_t Length;
+	bool HasCommentDelimiter;
+	bool EndsInComment;
+	bool StartsInComment;
+	URCL_Parser Parser;
+	URCL_Arena Arena;
+	URCL_InstructionInfo* Instructions;
+	URCL_LabelInfo* Labels;
+	URCL_InstructionInfo* Headers;
+	size_t InstructionCount;
+	size_t LabelCount;
+	size_t HeaderCount;
+	bool Parsed;
+} URCL_SourceChunk;
+
+typedef struct URCL_ParallelParse
+{
+	const URCL_Char* Source;
+	size_t Length;
+	URCL_SourceChunk* Chunks;
+} URCL_ParallelParse;
 
-		if (*resultLength > 1)
-		{
-			unsigned long immediateLength;
-			*isSpecialRegister = false;
-			return URCL_TryParseImmediate(value + 1, *resultLength - 1, result, &immediateLength);
-		}
-		else
-		{
-			URCL_SetError(URCL_Error_InvalidRegisterIndex, value + 1, 1);
-			return false;
-		}
-	}
-	else
-	{
-		URCL_ResetError();
+bool URCL_IsCommentStart(const URCL_Char* value, size_t length, size_t index)
+{
+	return (value[index] == '/') && ((index + 1) < length) && (value[index + 1] == '*');
+}
 
-		*resultLength = URCL_GetOperandLength(value, length);
+bool URCL_IsCommentEnd(const URCL_Char* value, size_t length, size_t index)
+{
+	return (value[index] == '*') && ((index + 1) < length) && (value[index + 1] == '/');
+}
 
-		if (URCL_IsStringEqualCaseInsensitive(u"SP", 2, value, *resultLength))
-		{
-			*isSpecialRegister = true;
-			*result = URCL_Register_StackPointer;
-			return true;
-		}
-		else if (URCL_IsStringEqualCaseInsensitive(u"PC", 2, value, *resultLength))
-		{
-			*isSpecialRegister = true;
-			*result = URCL_Register_ProgramCounter;
-			return true;
-		}
-		else
+void URCL_ScanChunkComments(void* context, size_t index)
+{
+	URCL_ParallelParse* parse = (URCL_ParallelParse*)context;
+	URCL_SourceChunk* chunk = &(parse->Chunks[index]);
+	chunk->HasCommentDelimiter = false;
+	chunk->EndsInComment = false;
+
+	for (size_t i = chunk->Start + chunk->Length; i > chunk->Start; i--)
+	{
+		if (URCL_IsCommentEnd(parse->Source, parse->Length, i - 1) || URCL_IsCommentStart(parse->Source, parse->Length, i - 1))
 		{
-			URCL_SetError(URCL_Error_UnknownRegister, value, *resultLength);
-			return false;
+			chunk->HasCommentDelimiter = true;
+			chunk->EndsInComment = parse->Source[i - 1] == '/';
+			break;
 		}
 	}
 }
 
-bool URCL_TryParseMacro(const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
+void URCL_FindChunkStart(void* context, size_t index)
 {
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseOperandWithPrefixes(URCL_Prefixes_Macro, value, length, &resultString, resultLength))
-	{
-		URCL_free(resultString);
+	URCL_ParallelParse* parse = (URCL_ParallelParse*)context;
+	URCL_SourceChunk* chunk = &(parse->Chunks[index]);
+	if (index == 0) return;
 
-		if (URCL_InvokeMacroHandler(value, *resultLength, result))
+	bool isInComment = chunk->StartsInComment;
+	size_t i = chunk->Start;
+	for (; i < parse->Length; i++)
+	{
+		if (isInComment)
 		{
-			return true;
+			if (URCL_IsCommentEnd(parse->Source, parse->Length, i)) isInComment = false;
 		}
-		else
+		else if (parse->Source[i] == '\n')
 		{
-			return false;
+			i++;
+			break;
 		}
+		
+		if (URCL_IsCommentStart(parse->Source, parse->Length, i)) isInComment = true;
 	}
-	else
-	{
-		return false;
-	}
+
+	chunk->Start = i;
 }
 
-bool URCL_TryParseOperand(const URCL_Char* value, unsigned long length, bool allowHeaderFields, URCL_OperandInfo* result, unsigned long* resultLength);
+void URCL_ParseChunk(void* context, size_t index)
+{
+	URCL_ParallelParse* parse = (URCL_ParallelParse*)context;
+	URCL_SourceChunk* chunk = &(parse->Chunks[index]);
+	chunk->Parsed = URCL_TryParseSourceEx(&(chunk->Parser), parse->Source + chunk->Start, chunk->Length, &(chunk->Instructions), &(chunk->Labels), &(chunk->Headers), &(chunk->InstructionCount), &(chunk->LabelCount), &(chunk->HeaderCount));
+}
 
-bool URCL_TryParseMacroOperand(const URCL_Char* value, unsigned long length, URCL_OperandInfo* result, unsigned long* resultLength)
+void URCL_ReleaseChunks(URCL_Parser* parser, URCL_SourceChunk* chunks, size_t chunkCount, bool releaseContents)
 {
-	URCL_Char* resultString = 0;
-	if (URCL_TryParseMacro(value, length, &resultString, resultLength))
+	for (size_t i = 0; i < chunkCount; i++)
 	{
-		unsigned long operandLength = 0;
-		for (; resultString[operandLength] != 0; operandLength++);
-
-		unsigned long parsedLength = 0;
-		if (URCL_TryParseOperand(resultString, operandLength, false, result, &parsedLength))
-		{
-			URCL_free(resultString);
-			return true;
-		}
-		else
+		if (chunks[i].Parsed)
 		{
-			URCL_free(resultString);
-			return false;
+			if (releaseContents)
+			{
+				URCL_ReleaseInstructions(parser, chunks[i].Instructions, chunks[i].InstructionCount);
+				URCL_ReleaseLabels(parser, chunks[i].Labels, chunks[i].LabelCount);
+				URCL_ReleaseInstructions(parser, chunks[i].Headers, chunks[i].HeaderCount);
+			}
+
+			URCL_Release(parser, chunks[i].Instructions);
+			URCL_Release(parser, chunks[i].Labels);
+			URCL_Release(parser, chunks[i].Headers);
 		}
+
+		if (parser->Arena != 0) URCL_ArenaAbsorb(parser->Arena, &(chunks[i].Arena));
 	}
-	else
-	{
-		return false;
-	}
+
+	URCL_free(chunks);
 }
 
-////description Attempts to parse the specified source string into an operand. Returns true if successful or false otherwise.
-bool URCL_TryParseOperand(const URCL_Char* value, unsigned long length, bool allowHeaderFields, URCL_OperandInfo* result, unsigned long* resultLength)
+////description Attempts to parse the specified source string like URCL_TryParseSourceEx, splitting it into at most the specified number of chunks that are parsed as separate tasks by the specified runner. The source is only split at line breaks that are outside of multi-line comments, so the results are identical to URCL_TryParseSourceEx. A source with @DEFINE lines is parsed sequentially if the parser has a constant table, since constants must be defined before they are used, and so is every source if the parser collects errors, builds a source map, has a data segment, or has an allocation or count limit. If the runner is null, the tasks are run sequentially. The macro handler must be safe to call from multiple threads if the runner runs tasks concurrently.
+bool URCL_TryParseSourceParallel(URCL_Parser* parser, const URCL_Char* source, size_t length, size_t chunkCount, URCL_TaskRunner runner, void* runnerData, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
 {
-	unsigned long startPadding = URCL_GetWhitespaceLength(value, length, false);
-	value += startPadding;
-	length -= startPadding;
-
-	if (length == 0)
-	{
-		URCL_SetError(URCL_Error_ExpectedOperand, value, 0);
-		return false;
-	}
+#ifdef URCL_Files
+	if (parser->CacheDirectory != 0) return URCL_TryParseCachedSource(parser, source, length, chunkCount, runner, runnerData, instructions, labels, headers, instructionCount, labelCount, headerCount);
+#endif
+	if (chunkCount > length) chunkCount = length;
+	if ((chunkCount <= 1) || (parser->Errors != 0) || (parser->SourceMap != 0) || (parser->DataSegment != 0) || URCL_HasParserCountLimits(parser) || ((parser->Defines != 0) && URCL_ContainsDefine(source, length))) return URCL_TryParseSourceEx(parser, source, length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+	if (runner == 0) runner = URCL_RunTasksSequentially;
 
-	result->Type = URCL_OperandType_None;
-	result->ImmediateValue = 0;
-	result->StringValue = 0;
+	URCL_ResetParserError(parser);
 
-	unsigned long trimmedLength = 0;
-	bool isSpecialRegister = false;
-	if (URCL_TryParseLabel(value, length, &(result->StringValue), &trimmedLength))
-	{
-		result->Type = URCL_OperandType_Label;
-	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParsePort(value, length, &(result->StringValue), &trimmedLength))
+	URCL_ParallelParse parse;
+	parse.Source = source;
+	parse.Length = length;
+	parse.Chunks = (URCL_SourceChunk*)URCL_malloc(chunkCount * sizeof(URCL_SourceChunk));
+
+	if (parse.Chunks == 0)
 	{
-		URCL_ResetError();
-		result->Type = URCL_OperandType_Port;
+		URCL_SetOutOfMemoryError(parser, source);
+		return false;
 	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseImmediate(value, length, &(result->ImmediateValue), &trimmedLength))
+
+	size_t segmentLength = length / chunkCount;
+	for (size_t i = 0; i < chunkCount; i++)
 	{
-		URCL_ResetError();
-		result->Type = URCL_OperandType_Immediate;
-		result->StringValue = URCL_Substring(value, 0, trimmedLength);
+		parse.Chunks[i].Start = i * segmentLength;
+		parse.Chunks[i].Length = (i == (chunkCount - 1)) ? (length - parse.Chunks[i].Start) : segmentLength;
 	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseRelative(value, length, (long long*)&(result->ImmediateValue), &trimmedLength))
+
+	runner(runnerData, URCL_ScanChunkComments, &parse, chunkCount);
+
+	bool isInComment = false;
+	for (size_t i = 0; i < chunkCount; i++)
 	{
-		URCL_ResetError();
-		result->Type = URCL_OperandType_Relative;
-		result->StringValue = URCL_Substring(value, 0, trimmedLength);
+		parse.Chunks[i].StartsInComment = isInComment;
+		if (parse.Chunks[i].HasCommentDelimiter) isInComment = parse.Chunks[i].EndsInComment;
 	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseMemoryAddress(value, length, &(result->ImmediateValue), &trimmedLength))
+
+	runner(runnerData, URCL_FindChunkStart, &parse, chunkCount);
+
+	size_t splitCount = 0;
+	for (size_t i = 0; i < chunkCount; i++)
 	{
-		URCL_ResetError();
-		result->Type = URCL_OperandType_MemoryAddress;
-		result->StringValue = URCL_Substring(value, 0, trimmedLength);
+		size_t start = parse.Chunks[i].Start;
+		if ((i > 0) && ((start >= length) || (start <= parse.Chunks[splitCount - 1].Start))) continue;
+
+		URCL_SourceChunk* chunk = &(parse.Chunks[splitCount]);
+		chunk->Start = start;
+		chunk->Parser = *parser;
+		chunk->Parsed = false;
+		URCL_InitArena(&(chunk->Arena), parser->Arena != 0 ? parser->Arena->BlockSize : 0);
+		if (parser->Arena != 0) chunk->Parser.Arena = &(chunk->Arena);
+		splitCount++;
 	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseMacroOperand(value, length, result, &trimmedLength))
+
+	for (size_t i = 0; i < splitCount; i++)
 	{
-		URCL_ResetError();
+		size_t end = (i == (splitCount - 1)) ? length : parse.Chunks[i + 1].Start;
+		parse.Chunks[i].Length = end - parse.Chunks[i].Start;
 	}
-	else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseRegister(value, length, &(result->ImmediateValue), &isSpecialRegister, &trimmedLength))
+
+	runner(runnerData, URCL_ParseChunk, &parse, splitCount);
+
+	size_t totalInstructions = 0;
+	size_t totalLabels = 0;
+	size_t totalHeaders = 0;
+	for (size_t i = 0; i < splitCount; i++)
 	{
-		URCL_ResetError();
-		result->Type = isSpecialRegister ? URCL_OperandType_SpecialRegister : URCL_OperandType_IndexedRegister;
-		result->StringValue = URCL_Substring(value, 0, trimmedLength);
+		if (!parse.Chunks[i].Parsed)
+		{
+			parser->Error = parse.Chunks[i].Parser.Error;
+			URCL_ReleaseChunks(parser, parse.Chunks, splitCount, true);
+			return false;
+		}
+
+		totalInstructions += parse.Chunks[i].InstructionCount;
+		totalLabels += parse.Chunks[i].LabelCount;
+		totalHeaders += parse.Chunks[i].HeaderCount;
 	}
-	else if (URCL_TryParseAny(value, length, &(result->StringValue), &trimmedLength))
+
+	if (parser->Arena != 0)
 	{
-		URCL_ResetError();
-		result->Type = URCL_OperandType_Any;
+		for (size_t i = 0; i < splitCount; i++) URCL_ArenaAbsorb(parser->Arena, &(parse.Chunks[i].Arena));
 	}
-	else
+
+	*instructions = (URCL_InstructionInfo*)URCL_Allocate(parser, (totalInstructions > 0 ? totalInstructions : 1) * sizeof(URCL_InstructionInfo));
+	*labels = (URCL_LabelInfo*)URCL_Allocate(parser, (totalLabels > 0 ? totalLabels : 1) * sizeof(URCL_LabelInfo));
+	*headers = (URCL_InstructionInfo*)URCL_Allocate(parser, (totalHeaders > 0 ? totalHeaders : 1) * sizeof(URCL_InstructionInfo));
+
+	if ((*instructions == 0) || (*labels == 0) || (*headers == 0))
 	{
+		URCL_SetOutOfMemoryError(parser, source);
+		URCL_Release(parser, *instructions);
+		URCL_Release(parser, *labels);
+		URCL_Release(parser, *headers);
+		URCL_ReleaseChunks(parser, parse.Chunks, splitCount, true);
 		return false;
 	}
 
-	if (URCL_HasError())
+	*instructionCount = 0;
+	*labelCount = 0;
+	*headerCount = 0;
+	for (size_t i = 0; i < splitCount; i++)
 	{
-		result->Type = URCL_OperandType_None;
-		result->ImmediateValue = 0;
-		if (result->StringValue != 0)
+		URCL_SourceChunk* chunk = &(parse.Chunks[i]);
+		URCL_memcpy(*headers + *headerCount, chunk->Headers, chunk->HeaderCount * sizeof(URCL_InstructionInfo));
+		URCL_memcpy(*instructions + *instructionCount, chunk->Instructions, chunk->InstructionCount * sizeof(URCL_InstructionInfo));
+
+		for (size_t j = 0; j < chunk->LabelCount; j++)
 		{
-			URCL_free(result->StringValue);
-			result->StringValue = 0;
+			(*labels)[*labelCount + j] = chunk->Labels[j];
+			(*labels)[*labelCount + j].Address += *instructionCount;
 		}
 
-		return false;
+		*instructionCount += chunk->InstructionCount;
+		*labelCount += chunk->LabelCount;
+		*headerCount += chunk->HeaderCount;
 	}
 
-	value += trimmedLength;
-	length -= trimmedLength;
-
-	unsigned long endPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength = startPadding + trimmedLength + endPadding;
+	URCL_ReleaseChunks(parser, parse.Chunks, splitCount, false);
 	return true;
 }
 
-unsigned long URCL_GetCommentLength(const URCL_Char* value, unsigned long length)
-{
-	unsigned long result = 0;
-
-	if (length >= 2 && value[0] == '/')
-	{
-		if (value[1] == '/')
-		{
-			for (; result < length; result++)
-			{
-				if (value[result] == '\n') break;
-			}
+////description The version of the binary program image format. Images with a different version are rejected when read.
+#define URCL_ImageVersion 2
+////description The value stored in every binary program image to reject images written with a different byte order.
+#define URCL_ImageByteOrder 0x01020304
 
-			return result;
-		}
-		else if (value[1] == '*')
-		{
-			URCL_Char previousChar = 0;
-			for (; result < length; result++)
-			{
-				URCL_Char currentChar = value[result];
-				
-				if (currentChar == '/' && previousChar == '*')
-				{
-					result++;
-					return result;
-				}
+#define URCL_ImageString_None 0
+#define URCL_ImageString_Source 1
+#define URCL_ImageString_Pool 2
 
-				previousChar = currentChar;
-			}
-		}
-	}
+////description Represents the start of a binary program image. The header is followed by the instruction and header records, the operand records, the label records, the string pool, and a copy of the source.
+typedef struct URCL_ImageHeader
+{
+	////class URCL_ImageHeader
+	////description The characters "URCL".
+	char Magic[4];
+	////class URCL_ImageHeader
+	////description The version of the image format.
+	unsigned int Version;
+	////class URCL_ImageHeader
+	////description The byte order mark of the image.
+	unsigned int ByteOrder;
+	////class URCL_ImageHeader
+	////description The size of an URCL_Char in bytes.
+	unsigned int CharSize;
+	////class URCL_ImageHeader
+	////description The number of opcodes known by the writer of the image.
+	unsigned int OpcodeCount;
+	unsigned int Reserved;
+	////class URCL_ImageHeader
+	////description The key identifying the source and the parser settings the image was written for.
+	unsigned long long Key;
+	////class URCL_ImageHeader
+	////description The number of characters in the source the image was written for.
+	unsigned long long SourceLength;
+	////class URCL_ImageHeader
+	////description The number of instruction records, which are followed by the header records.
+	unsigned long long InstructionCount;
+	////class URCL_ImageHeader
+	////description The number of header records.
+	unsigned long long HeaderCount;
+	////class URCL_ImageHeader
+	////description The number of operand records.
+	unsigned long long OperandCount;
+	////class URCL_ImageHeader
+	////description The number of label records.
+	unsigned long long LabelCount;
+	////class URCL_ImageHeader
+	////description The number of characters in the string pool.
+	unsigned long long PoolLength;
+} URCL_ImageHeader;
+
+typedef struct URCL_ImageString
+{
+	unsigned long long Offset;
+	unsigned long long Length;
+	unsigned int Kind;
+	unsigned int Reserved;
+} URCL_ImageString;
 
-	return 0;
-}
+typedef struct URCL_ImageOperand
+{
+	unsigned long long ImmediateValue;
+	URCL_ImageString Value;
+	unsigned int Type;
+	unsigned int Reserved;
+} URCL_ImageOperand;
 
-////description Returns true if the specified string matches a known header or false otherwise.
-bool URCL_IsInstructionHeaderName(URCL_Char* name, unsigned long nameLength)
+typedef struct URCL_ImageInstruction
 {
-	return URCL_IsStringEqualCaseInsensitive(URCL_Header_Bits, URCL_CharsLength(URCL_Header_Bits), name, nameLength) ||
-		URCL_IsStringEqualCaseInsensitive(URCL_Header_MinimumRegisters, URCL_CharsLength(URCL_Header_MinimumRegisters), name, nameLength) ||
-		URCL_IsStringEqualCaseInsensitive(URCL_Header_MinimumHeap, URCL_CharsLength(URCL_Header_MinimumHeap), name, nameLength) ||
-		URCL_IsStringEqualCaseInsensitive(URCL_Header_MinimumStack, URCL_CharsLength(URCL_Header_MinimumStack), name, nameLength) ||
-		URCL_IsStringEqualCaseInsensitive(URCL_Header_InstructionStorage, URCL_CharsLength(URCL_Header_InstructionStorage), name, nameLength);
-}
+	URCL_ImageString Operation;
+	unsigned int Opcode;
+	unsigned int OperandCount;
+} URCL_ImageInstruction;
 
-////description Returns true if an instruction is a known header or false otherwise.
-bool URCL_IsInstructionHeader(URCL_InstructionInfo* instruction)
+typedef struct URCL_ImageLabel
 {
-	URCL_Char* name = instruction->Operation;
-	unsigned long nameLength = URCL_CharsLength(name);
-	return URCL_IsInstructionHeaderName(name, nameLength);
-}
+	unsigned long long Address;
+	URCL_ImageString Name;
+} URCL_ImageLabel;
 
-////description Attempts to parse the specified source string into an instruction. Returns true if successful or false otherwise.
-bool URCL_TryParseInstruction(const URCL_Char* value, unsigned long length, URCL_InstructionInfo* result, unsigned long* resultLength)
+size_t URCL_CountImageOperands(URCL_InstructionInfo* instructions, size_t count)
 {
-	URCL_ResetError();
-	*resultLength = 0;
+	size_t result = 0;
 
-	unsigned long preCommentPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += preCommentPadding;
-	value += preCommentPadding;
-	length -= preCommentPadding;
+	for (size_t i = 0; i < count; i++)
+	{
+		for (size_t j = 0; (j < URCL_MaxOperands) && (instructions[i].Operands[j].Type != URCL_OperandType_None); j++) result++;
+	}
 
-	unsigned long preCommentLength = URCL_GetCommentLength(value, length);
-	*resultLength += preCommentLength;
-	value += preCommentLength;
-	length -= preCommentLength;
+	return result;
+}
 
-	unsigned long startPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += startPadding;
-	value += startPadding;
-	length -= startPadding;
+size_t URCL_GetImagePoolLength(const URCL_Char* value, size_t valueLength, bool isSourceView)
+{
+	return ((value != 0) && !isSourceView) ? valueLength : 0;
+}
 
-	unsigned long operationLength = URCL_GetOperandLength(value, length);
-	*resultLength += operationLength;
-	value += operationLength;
-	length -= operationLength;
+void URCL_WriteImageString(URCL_ImageString* result, const URCL_Char* value, size_t valueLength, bool isSourceView, const URCL_Char* source, URCL_Char* pool, size_t* poolLength)
+{
+	result->Length = valueLength;
+	result->Reserved = 0;
 
-	if (operationLength == 0)
+	if (value == 0)
 	{
-		*resultLength = 0;
-		URCL_SetError(URCL_Error_ExpectedOperation, value, 0);
-		return false;
+		result->Kind = URCL_ImageString_None;
+		result->Offset = 0;
 	}
-
-	result->Operation = URCL_Substring(value - operationLength, 0, operationLength);
-
-	for (unsigned long i = 0; i < URCL_MaxOperands; i++)
+	else if (isSourceView)
 	{
-		result->Operands[i].Type = URCL_OperandType_None;
-		result->Operands[i].ImmediateValue = 0;
-		result->Operands[i].StringValue = 0;
+		result->Kind = URCL_ImageString_Source;
+		result->Offset = (unsigned long long)(value - source);
 	}
+	else
+	{
+		result->Kind = URCL_ImageString_Pool;
+		result->Offset = *poolLength;
+		URCL_memcpy(pool + *poolLength, value, valueLength * sizeof(URCL_Char));
+		*poolLength += valueLength;
+	}
+}
 
-	unsigned long endPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += endPadding;
-	value += endPadding;
-	length -= endPadding;
-
-	unsigned long commentLength = URCL_GetCommentLength(value, length);
-	*resultLength += commentLength;
-	value += commentLength;
-	length -= commentLength;
+void URCL_WriteImageInstructions(URCL_InstructionInfo* instructions, size_t count, const URCL_Char* source, URCL_ImageInstruction* records, URCL_ImageOperand** operands, URCL_Char* pool, size_t* poolLength)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		URCL_InstructionInfo* instruction = &(instructions[i]);
+		URCL_ImageInstruction* record = &(records[i]);
+		record->Opcode = (unsigned int)instruction->Opcode;
+		record->OperandCount = 0;
 
-	unsigned long trailingPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += trailingPadding;
-	value += trailingPadding;
-	length -= trailingPadding;
+		if (instruction->Opcode != URCL_Opcode_Unknown) URCL_WriteImageString(&(record->Operation), 0, 0, false, source, pool, poolLength);
+		else URCL_WriteImageString(&(record->Operation), instruction->Operation, instruction->OperationLength, instruction->IsSourceView, source, pool, poolLength);
 
-	if (length == 0) return true;
+		for (size_t j = 0; (j < URCL_MaxOperands) && (instruction->Operands[j].Type != URCL_OperandType_None); j++)
+		{
+			URCL_OperandInfo* operand = &(instruction->Operands[j]);
+			URCL_ImageOperand* operandRecord = (*operands)++;
+			operandRecord->ImmediateValue = operand->ImmediateValue;
+			operandRecord->Type = (unsigned int)operand->Type;
+			operandRecord->Reserved = 0;
+			URCL_WriteImageString(&(operandRecord->Value), operand->StringValue, operand->StringLength, operand->IsSourceView, source, pool, poolLength);
+			record->OperandCount++;
+		}
+	}
+}
 
-	bool isHeader = URCL_IsInstructionHeaderName(result->Operation, URCL_CharsLength(result->Operation));
+////description Attempts to write the specified parse results of the specified source into a binary program image allocated with URCL_malloc. Strings that are views into the source are stored as offsets into it, and other strings are stored in the string pool of the image. The key and a copy of the source are stored in the image so that it can only be read back for the same settings and the exact same source, even if two sources share a key. Returns true if successful or false otherwise.
+bool URCL_TryWriteProgramImage(URCL_Parser* parser, unsigned long long key, const URCL_Char* source, size_t length, URCL_InstructionInfo* instructions, URCL_LabelInfo* labels, URCL_InstructionInfo* headers, size_t instructionCount, size_t labelCount, size_t headerCount, void** image, size_t* imageSize)
+{
+	size_t operandCount = URCL_CountImageOperands(instructions, instructionCount) + URCL_CountImageOperands(headers, headerCount);
+	size_t poolLength = 0;
 
-	for (unsigned long i = 0; i < URCL_MaxOperands && ((length > 0) && (*value != '\n')); i++)
+	for (size_t i = 0; i < instructionCount + headerCount; i++)
 	{
-		unsigned long preOperandPadding = URCL_GetWhitespaceLength(value, length, false);
-		*resultLength += preOperandPadding;
-		value += preOperandPadding;
-		length -= preOperandPadding;
+		URCL_InstructionInfo* instruction = (i < instructionCount) ? &(instructions[i]) : &(headers[i - instructionCount]);
+		if (instruction->Opcode == URCL_Opcode_Unknown) poolLength += URCL_GetImagePoolLength(instruction->Operation, instruction->OperationLength, instruction->IsSourceView);
 
-		unsigned long preOperandCommentLength = URCL_GetCommentLength(value, length);
-		*resultLength += preOperandCommentLength;
-		value += preOperandCommentLength;
-		length -= preOperandCommentLength;
-
-		unsigned long operandLength = 0;
-		if (URCL_TryParseOperand(value, length, isHeader, &(result->Operands[i]), &operandLength))
+		for (size_t j = 0; j < URCL_MaxOperands; j++)
 		{
-			*resultLength += operandLength;
-			value += operandLength;
-			length -= operandLength;
+			URCL_OperandInfo* operand = &(instruction->Operands[j]);
+			if (operand->Type != URCL_OperandType_None) poolLength += URCL_GetImagePoolLength(operand->StringValue, operand->StringLength, operand->IsSourceView);
+		}
+	}
 
-			unsigned long postOperandCommentLength = URCL_GetCommentLength(value, length);
-			*resultLength += postOperandCommentLength;
-			value += postOperandCommentLength;
-			length -= postOperandCommentLength;
+	for (size_t i = 0; i < labelCount; i++) poolLength += URCL_GetImagePoolLength(labels[i].Name, labels[i].NameLength, labels[i].IsSourceView);
 
-			unsigned long operandPadding = URCL_GetWhitespaceLength(value, length, false);
-			*resultLength += operandPadding;
-			value += operandPadding;
-			length -= operandPadding;
+	size_t size = sizeof(URCL_ImageHeader) + ((instructionCount + headerCount) * sizeof(URCL_ImageInstruction)) + (operandCount * sizeof(URCL_ImageOperand)) + (labelCount * sizeof(URCL_ImageLabel)) + ((poolLength + length) * sizeof(URCL_Char));
+	char* data = (char*)URCL_malloc(size);
 
-			if (length > 0 && value[0] == ',')
-			{
-				*resultLength += 1;
-				value += 1;
-				length -= 1;
+	if (data == 0)
+	{
+		URCL_SetOutOfMemoryError(parser, source);
+		return false;
+	}
 
-				if (length == 0)
-				{
-					*resultLength = 0;
-					URCL_SetError(URCL_Error_ExpectedOperand, value - 1, 1);
-					URCL_FreeInstructions(result, 1);
-					return false;
-				}
-			}
-		}
-		else
-		{
-			*resultLength = 0;
-			URCL_FreeInstructions(result, 1);
-			return false;
-		}
+	URCL_ImageHeader* header = (URCL_ImageHeader*)data;
+	header->Magic[0] = 'U';
+	header->Magic[1] = 'R';
+	header->Magic[2] = 'C';
+	header->Magic[3] = 'L';
+	header->Version = URCL_ImageVersion;
+	header->ByteOrder = URCL_ImageByteOrder;
+	header->CharSize = sizeof(URCL_Char);
+	header->OpcodeCount = URCL_OpcodeCount;
+	header->Reserved = 0;
+	header->Key = key;
+	header->SourceLength = length;
+	header->InstructionCount = instructionCount;
+	header->HeaderCount = headerCount;
+	header->OperandCount = operandCount;
+	header->LabelCount = labelCount;
+	header->PoolLength = poolLength;
+
+	URCL_ImageInstruction* instructionRecords = (URCL_ImageInstruction*)(data + sizeof(URCL_ImageHeader));
+	URCL_ImageOperand* operandRecords = (URCL_ImageOperand*)(instructionRecords + instructionCount + headerCount);
+	URCL_ImageLabel* labelRecords = (URCL_ImageLabel*)(operandRecords + operandCount);
+	URCL_Char* pool = (URCL_Char*)(labelRecords + labelCount);
+
+	poolLength = 0;
+	URCL_WriteImageInstructions(instructions, instructionCount, source, instructionRecords, &operandRecords, pool, &poolLength);
+	URCL_WriteImageInstructions(headers, headerCount, source, instructionRecords + instructionCount, &operandRecords, pool, &poolLength);
+
+	for (size_t i = 0; i < labelCount; i++)
+	{
+		labelRecords[i].Address = labels[i].Address;
+		URCL_WriteImageString(&(labelRecords[i].Name), labels[i].Name, labels[i].NameLength, labels[i].IsSourceView, source, pool, &poolLength);
 	}
 
-	if (!URCL_HasError() && ((length == 0) || (*value == '\n'))) return true;
+	URCL_memcpy(pool + poolLength, source, length * sizeof(URCL_Char));
 
-	*resultLength = 0;
-	URCL_FreeInstructions(result, 1);
-	return false;
+	*image = data;
+	*imageSize = size;
+	return true;
 }
 
-bool URCL_TryParseMacroInstruction(const URCL_Char* value, unsigned long length, URCL_InstructionInfo* result, unsigned long* resultLength)
+typedef struct URCL_ImageReader
 {
-	URCL_ResetError();
+	const URCL_Char* Source;
+	size_t Length;
+	const URCL_Char* Pool;
+	size_t PoolLength;
+	const URCL_ImageOperand* Operands;
+	size_t OperandCount;
+} URCL_ImageReader;
+
+bool URCL_TryReadImageString(URCL_Parser* parser, URCL_ImageReader* reader, const URCL_ImageString* value, URCL_Char** result, size_t* resultLength, bool* isSourceView)
+{
+	*result = 0;
 	*resultLength = 0;
+	*isSourceView = false;
 
-	unsigned long preCommentPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += preCommentPadding;
-	value += preCommentPadding;
-	length -= preCommentPadding;
+	if (value->Kind == URCL_ImageString_None) return value->Length == 0;
 
-	unsigned long preCommentLength = URCL_GetCommentLength(value, length);
-	*resultLength += preCommentLength;
-	value += preCommentLength;
-	length -= preCommentLength;
+	if (value->Kind == URCL_ImageString_Source)
+	{
+		if ((value->Offset > reader->Length) || (value->Length > (reader->Length - value->Offset))) return false;
 
-	unsigned long startPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += startPadding;
-	value += startPadding;
-	length -= startPadding;
+		*resultLength = (size_t)value->Length;
+		*isSourceView = parser->SourceViews;
+		*result = URCL_GetTokenString(parser, reader->Source + value->Offset, (size_t)value->Length);
+		return *result != 0;
+	}
 
-	URCL_Char* resultString = 0;
-	unsigned long macroLength = 0;
-	if (URCL_TryParseMacro(value, length, &resultString, &macroLength))
+	if (value->Kind == URCL_ImageString_Pool)
 	{
-		*resultLength += macroLength;
-		value += macroLength;
-		length -= macroLength;
+		if ((value->Offset > reader->PoolLength) || (value->Length > (reader->PoolLength - value->Offset))) return false;
 
-		unsigned long instructionLength = 0;
-		for (; resultString[instructionLength] != 0; instructionLength++);
+		*resultLength = (size_t)value->Length;
+		*result = URCL_Substring(parser, reader->Pool + value->Offset, 0, (size_t)value->Length);
+		return *result != 0;
+	}
 
-		unsigned long parsedLength = 0;
-		if (URCL_TryParseInstruction(resultString, instructionLength, result, &parsedLength))
-		{
-			URCL_free(resultString);
+	return false;
+}
 
-			unsigned long endPadding = URCL_GetWhitespaceLength(value, length, false);
-			*resultLength += endPadding;
-			value += endPadding;
-			length -= endPadding;
+bool URCL_IsImageSourceEqual(const URCL_Char* copy, const URCL_Char* source, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		if (copy[i] != source[i]) return false;
+	}
+	return true;
+}
 
-			unsigned long commentLength = URCL_GetCommentLength(value, length);
-			*resultLength += commentLength;
-			value += commentLength;
-			length -= commentLength;
+bool URCL_TryReadImageInstruction(URCL_Parser* parser, URCL_ImageReader* reader, const URCL_ImageInstruction* record, URCL_InstructionInfo* result)
+{
+	result->Operation = 0;
+	result->OperationLength = 0;
+	result->IsSourceView = false;
+	result->Opcode = record->Opcode;
 
-			unsigned long trailingPadding = URCL_GetWhitespaceLength(value, length, false);
-			*resultLength += trailingPadding;
-			value += trailingPadding;
-			length -= trailingPadding;
+	for (size_t i = 0; i < URCL_MaxOperands; i++)
+	{
+		result->Operands[i].Type = URCL_OperandType_None;
+		result->Operands[i].ImmediateValue = 0;
+		result->Operands[i].StringValue = 0;
+		result->Operands[i].StringLength = 0;
+		result->Operands[i].IsSourceView = false;
+	}
 
-			if (!URCL_HasError() && ((length == 0) || (*value == '\n')))
-			{
-				return true;
-			}
-			else
-			{
-				*resultLength = 0;
-				return false;
-			}
-		}
-		else
-		{
-			*resultLength = 0;
-			URCL_free(resultString);
-			return false;
-		}
+	if ((record->Opcode >= URCL_OpcodeCount) || (record->OperandCount > URCL_MaxOperands) || (record->OperandCount > reader->OperandCount)) return false;
+
+	if (record->Opcode != URCL_Opcode_Unknown)
+	{
+		result->Operation = (URCL_Char*)URCL_OpcodeNames[record->Opcode];
+		result->OperationLength = URCL_OpcodeNameLengths[record->Opcode];
+		result->IsSourceView = true;
 	}
-	else
+	else if (!URCL_TryReadImageString(parser, reader, &(record->Operation), &(result->Operation), &(result->OperationLength), &(result->IsSourceView)))
 	{
-		*resultLength = 0;
 		return false;
 	}
-}
 
-bool URCL_TryParseLabelLine(const URCL_Char* value, unsigned long length, URCL_Char** result, unsigned long* resultLength)
-{
-	URCL_ResetError();
-	*resultLength = 0;
+	for (size_t i = 0; i < record->OperandCount; i++)
+	{
+		const URCL_ImageOperand* operandRecord = reader->Operands++;
+		reader->OperandCount--;
 
-	unsigned long preCommentPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += preCommentPadding;
-	value += preCommentPadding;
-	length -= preCommentPadding;
+		URCL_OperandInfo* operand = &(result->Operands[i]);
+		if ((operandRecord->Type == URCL_OperandType_None) || (operandRecord->Type > URCL_OperandType_Any)) return false;
+		if (!URCL_TryReadImageString(parser, reader, &(operandRecord->Value), &(operand->StringValue), &(operand->StringLength), &(operand->IsSourceView))) return false;
 
-	unsigned long preCommentLength = URCL_GetCommentLength(value, length);
-	*resultLength += preCommentLength;
-	value += preCommentLength;
-	length -= preCommentLength;
+		operand->Type = operandRecord->Type;
+		operand->ImmediateValue = operandRecord->ImmediateValue;
+	}
 
-	unsigned long startPadding = URCL_GetWhitespaceLength(value, length, false);
-	*resultLength += startPadding;
-	value += startPadding;
-	length -= startPadding;
+	return true;
+}
+
+bool URCL_TryReadImageInstructions(URCL_Parser* parser, URCL_ImageReader* reader, const URCL_ImageInstruction* records, size_t count, URCL_InstructionInfo** results, size_t* resultCount)
+{
+	*resultCount = 0;
+	*results = (URCL_InstructionInfo*)URCL_Allocate(parser, (count > 0 ? count : 1) * sizeof(URCL_InstructionInfo));
 
-	unsigned long labelLength = 0;
-	if (URCL_TryParseLabel(value, length, result, &labelLength))
+	if (*results == 0)
 	{
-		*resultLength += labelLength;
-		value += labelLength;
-		length -= labelLength;
+		URCL_SetOutOfMemoryError(parser, reader->Source);
+		return false;
+	}
 
-		unsigned long endPadding = URCL_GetWhitespaceLength(value, length, false);
-		*resultLength += endPadding;
-		value += endPadding;
-		length -= endPadding;
+	for (size_t i = 0; i < count; i++)
+	{
+		(*resultCount)++;
+		if (!URCL_TryReadImageInstruction(parser, reader, &(records[i]), &((*results)[i]))) return false;
+	}
 
-		unsigned long commentLength = URCL_GetCommentLength(value, length);
-		*resultLength += commentLength;
-		value += commentLength;
-		length -= commentLength;
+	return true;
+}
 
-		unsigned long trailingPadding = URCL_GetWhitespaceLength(value, length, false);
-		*resultLength += trailingPadding;
-		value += trailingPadding;
-		length -= trailingPadding;
+////description Attempts to read parse results from the specified binary program image, which must have been written for the specified key and source. The copy of the source in the image is compared with the specified source before anything is read. Arrays and strings are allocated with the specified parser as they would be by a parse, and strings that were views into the source when the image was written are views into the specified source again if the parser uses source views. Returns true if successful or false if the image is invalid or does not match.
+bool URCL_TryReadProgramImage(URCL_Parser* parser, unsigned long long key, const void* image, size_t imageSize, const URCL_Char* source, size_t length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+	URCL_ResetParserError(parser);
+
+	const char* data = (const char*)image;
+	const URCL_ImageHeader* header = (const URCL_ImageHeader*)data;
+	size_t remaining = imageSize - sizeof(URCL_ImageHeader);
+
+	bool valid = (imageSize >= sizeof(URCL_ImageHeader)) && (header->Magic[0] == 'U') && (header->Magic[1] == 'R') && (header->Magic[2] == 'C') && (header->Magic[3] == 'L') &&
+		(header->Version == URCL_ImageVersion) && (header->ByteOrder == URCL_ImageByteOrder) && (header->CharSize == sizeof(URCL_Char)) && (header->OpcodeCount == URCL_OpcodeCount) &&
+		(header->Key == key) && (header->SourceLength == length);
+
+	valid = valid && (header->InstructionCount <= (remaining / sizeof(URCL_ImageInstruction))) && (header->HeaderCount <= ((remaining / sizeof(URCL_ImageInstruction)) - header->InstructionCount));
+	if (valid) remaining -= (size_t)(header->InstructionCount + header->HeaderCount) * sizeof(URCL_ImageInstruction);
+	valid = valid && (header->OperandCount <= (remaining / sizeof(URCL_ImageOperand)));
+	if (valid) remaining -= (size_t)header->OperandCount * sizeof(URCL_ImageOperand);
+	valid = valid && (header->LabelCount <= (remaining / sizeof(URCL_ImageLabel)));
+	if (valid) remaining -= (size_t)header->LabelCount * sizeof(URCL_ImageLabel);
+	valid = valid && ((remaining % sizeof(URCL_Char)) == 0) && (header->PoolLength <= (remaining / sizeof(URCL_Char))) && (header->SourceLength == ((remaining / sizeof(URCL_Char)) - header->PoolLength));
+	valid = valid && URCL_IsImageSourceEqual((const URCL_Char*)(data + imageSize - (length * sizeof(URCL_Char))), source, length);
+
+	if (!valid)
+	{
+		URCL_SetParserError(parser, URCL_Error_InvalidImage, source, 0);
+		return false;
+	}
 
-		if (!URCL_HasError() && ((length == 0) || (*value == '\n')))
-		{
-			return true;
-		}
-		else
-		{
-			*resultLength = 0;
-			return false;
-		}
+	const URCL_ImageInstruction* instructionRecords = (const URCL_ImageInstruction*)(data + sizeof(URCL_ImageHeader));
+	const URCL_ImageOperand* operandRecords = (const URCL_ImageOperand*)(instructionRecords + header->InstructionCount + header->HeaderCount);
+	const URCL_ImageLabel* labelRecords = (const URCL_ImageLabel*)(operandRecords + header->OperandCount);
+
+	URCL_ImageReader reader;
+	reader.Source = source;
+	reader.Length = length;
+	reader.Pool = (const URCL_Char*)(labelRecords + header->LabelCount);
+	reader.PoolLength = (size_t)header->PoolLength;
+	reader.Operands = operandRecords;
+	reader.OperandCount = (size_t)header->OperandCount;
+
+	*instructions = 0;
+	*labels = 0;
+	*headers = 0;
+	*instructionCount = 0;
+	*labelCount = 0;
+	*headerCount = 0;
+
+	bool read = URCL_TryReadImageInstructions(parser, &reader, instructionRecords, (size_t)header->InstructionCount, instructions, instructionCount) &&
+		URCL_TryReadImageInstructions(parser, &reader, instructionRecords + header->InstructionCount, (size_t)header->HeaderCount, headers, headerCount);
+
+	if (read)
+	{
+		*labels = (URCL_LabelInfo*)URCL_Allocate(parser, (header->LabelCount > 0 ? (size_t)header->LabelCount : 1) * sizeof(URCL_LabelInfo));
+		read = *labels != 0;
+		if (!read) URCL_SetOutOfMemoryError(parser, source);
 	}
-	else
+
+	for (size_t i = 0; read && (i < header->LabelCount); i++)
 	{
-		*resultLength = 0;
-		return false;
+		URCL_LabelInfo* label = &((*labels)[i]);
+		label->Address = labelRecords[i].Address;
+		(*labelCount)++;
+		read = URCL_TryReadImageString(parser, &reader, &(labelRecords[i].Name), &(label->Name), &(label->NameLength), &(label->IsSourceView));
 	}
+
+	if (read && (reader.OperandCount == 0)) return true;
+
+	if (!URCL_ParserHasError(parser)) URCL_SetParserError(parser, URCL_Error_InvalidImage, source, 0);
+	if (*instructions != 0) URCL_ReleaseInstructions(parser, *instructions, *instructionCount);
+	if (*labels != 0) URCL_ReleaseLabels(parser, *labels, *labelCount);
+	if (*headers != 0) URCL_ReleaseInstructions(parser, *headers, *headerCount);
+	URCL_Release(parser, *instructions);
+	URCL_Release(parser, *labels);
+	URCL_Release(parser, *headers);
+	return false;
 }
 
-bool URCL_TryGrowInstructionsArray(URCL_InstructionInfo** instructions, unsigned long* capacity)
+#ifdef URCL_Files
+////description Returns a key identifying the specified source together with the parser settings that affect its parse results. Parse results are cached under this key.
+unsigned long long URCL_GetSourceKey(URCL_Parser* parser, const URCL_Char* source, size_t length)
 {
-	*capacity *= 2;
-	void* resized = URCL_realloc(*instructions, *capacity * sizeof(URCL_InstructionInfo));
+	unsigned long long hash = 0xCBF29CE484222325ULL ^ length;
+	hash = (hash ^ parser->TargetBits) * 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (parser->SourceViews ? 1 : 0) ^ ((parser->MacroHandler == URCL_BasicMacroHandlerEx) ? 2 : 0)) * 0x9E3779B97F4A7C15ULL;
 
-	if (resized == 0)
+	size_t i = 0;
+	for (; (length - i) >= URCL_SwarLanes; i += URCL_SwarLanes)
 	{
-		*capacity /= 2;
-		return false;
+		hash = (hash ^ URCL_SwarLoad(source + i)) * 0x9E3779B97F4A7C15ULL;
+		hash ^= hash >> 29;
 	}
-	
-	*instructions = (URCL_InstructionInfo*)resized;
-	return true;
+
+	for (; i < length; i++) hash = (hash ^ source[i]) * 0x100000001B3ULL;
+
+	hash ^= hash >> 32;
+	return hash;
 }
 
-////description Attempts to parse the specified source string into instructions, labels, and headers. Returns true if the parsing finished successfully or false otherwise. Instruction, label, and header arrays are only valid if the result is true.
-bool URCL_TryParseSource(const URCL_Char* source, unsigned long length, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, unsigned long* instructionCount, unsigned long* labelCount, unsigned long* headerCount)
+char* URCL_GetCachePath(const char* directory, unsigned long long key, const char* extension)
 {
-	unsigned long resultCapacity = 1;
-	unsigned long resultLength = 0;
-	*instructions = (URCL_InstructionInfo*)URCL_malloc(resultCapacity * sizeof(URCL_InstructionInfo));
+	size_t directoryLength = 0;
+	for (; directory[directoryLength] != 0; directoryLength++);
 
-	unsigned long labelsCapacity = 1;
-	unsigned long labelsLength = 0;
-	*labels = (URCL_LabelInfo*)URCL_malloc(labelsCapacity * sizeof(URCL_LabelInfo));
+	size_t extensionLength = 0;
+	for (; extension[extensionLength] != 0; extensionLength++);
 
-	unsigned long headersCapacity = 1;
-	unsigned long headersLength = 0;
-	*headers = (URCL_InstructionInfo*)URCL_malloc(headersCapacity * sizeof(URCL_InstructionInfo));
+	char* result = (char*)URCL_malloc(directoryLength + 18 + extensionLength);
+	if (result == 0) return 0;
 
-	while (length > 0)
+	URCL_memcpy(result, directory, directoryLength);
+	result[directoryLength] = '/';
+
+	for (size_t i = 0; i < 16; i++) result[directoryLength + 1 + i] = "0123456789abcdef"[(key >> ((15 - i) * 4)) & 0xF];
+
+	URCL_memcpy(result + directoryLength + 17, extension, extensionLength + 1);
+	return result;
+}
+
+bool URCL_TryWriteFile(const char* path, const void* data, size_t size)
+{
+	int descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0) return false;
+
+	size_t written = 0;
+	while (written < size)
 	{
-		bool generatedNewInstruction = false;
-		URCL_Char* labelName = 0;
-		unsigned long offset = 0;
-		if (URCL_TryParseLabelLine(source, length, &labelName, &offset))
-		{
-			(*labels)[labelsLength].Name = labelName;
-			(*labels)[labelsLength].Address = resultLength;
-			labelsLength++;
-			
-			if (labelsLength == labelsCapacity)
-			{
-				labelsCapacity *= 2;
-				void* resized = URCL_realloc(*labels, labelsCapacity * sizeof(URCL_LabelInfo));
+		ssize_t count = write(descriptor, (const char*)data + written, size - written);
+		if (count <= 0) break;
 
-				if (resized == 0)
-				{
-					URCL_SetError(URCL_Error_OutOfMemory, source, offset);
-					URCL_FreeInstructions(*instructions, resultLength);
-					URCL_FreeLabels(*labels, labelsLength);
-					URCL_FreeInstructions(*headers, headersLength);
-					URCL_free(*instructions);
-					URCL_free(*labels);
-					return false;
-				}
+		written += (size_t)count;
+	}
 
-				*labels = (URCL_LabelInfo*)resized;
-			}
-		}
-		else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseMacroInstruction(source, length, &((*instructions)[resultLength]), &offset))
-		{
-			URCL_ResetError();
-			generatedNewInstruction = true;
-		}
-		else if ((URCL_Error.Message == URCL_Error_MissingOperandPrefix) && URCL_TryParseInstruction(source, length, &((*instructions)[resultLength]), &offset))
-		{
-			URCL_ResetError();
-			generatedNewInstruction = true;
-		}
-		else
-		{
-			if (URCL_Error.Message == URCL_Error_ExpectedOperation)
-			{
-				URCL_ResetError();
-				offset = URCL_GetLineLength(source, length);
-			}
-			else
-			{
-				URCL_FreeInstructions(*instructions, resultLength);
-				URCL_FreeLabels(*labels, labelsLength);
-				URCL_FreeInstructions(*headers, headersLength);
-				URCL_free(*instructions);
-				URCL_free(*labels);
-				URCL_free(*headers);
-				return false;
-			}
-		}
+	return (close(descriptor) == 0) && (written == size);
+}
 
-		if (generatedNewInstruction)
-		{
-			bool outOfMemory = false;
-			if (URCL_IsInstructionHeader(&((*instructions)[resultLength])))
-			{
-				(*headers)[headersLength] = (*instructions)[resultLength];
-				headersLength++;
-				if (headersLength == headersCapacity) outOfMemory = !URCL_TryGrowInstructionsArray(headers, &headersCapacity);
-			}
-			else
-			{
-				resultLength++;
-				if (resultLength == resultCapacity) outOfMemory = !URCL_TryGrowInstructionsArray(instructions, &resultCapacity);
-			}
-			
-			if (outOfMemory)
-			{
-				URCL_SetError(URCL_Error_OutOfMemory, source, offset);
-				URCL_FreeInstructions(*instructions, resultLength);
-				URCL_FreeLabels(*labels, labelsLength);
-				URCL_free(*instructions);
-				URCL_free(*labels);
-				URCL_free(*headers);
-				return false;
-			}
-		}
+bool URCL_TryParseCachedSource(URCL_Parser* parser, const URCL_Char* source, size_t length, size_t chunkCount, URCL_TaskRunner runner, void* runnerData, URCL_InstructionInfo** instructions, URCL_LabelInfo** labels, URCL_InstructionInfo** headers, size_t* instructionCount, size_t* labelCount, size_t* headerCount)
+{
+	const char* directory = parser->CacheDirectory;
+	bool isCacheable = (parser->Errors == 0) && (parser->SourceMap == 0) && (parser->DataSegment == 0) && !URCL_HasParserCountLimits(parser) && (parser->Limits.MaxTokenLength == 0) && ((parser->MacroHandler == URCL_BasicMacroHandlerEx) || (parser->MacroHandler == URCL_NoMacroHandlerEx)) && (parser->MacroOperandHandler == 0) && (parser->MacroInstructionHandler == 0) && ((parser->Defines == 0) || ((parser->Defines->Count == 0) && !URCL_ContainsDefine(source, length)));
+	unsigned long long key = isCacheable ? URCL_GetSourceKey(parser, source, length) : 0;
+	char* path = isCacheable ? URCL_GetCachePath(directory, key, ".urclc") : 0;
 
-		source += offset;
-		length -= offset;
+	URCL_SourceFile file;
+	if ((path != 0) && URCL_TryLoadFile(path, &file))
+	{
+		bool read = URCL_TryReadProgramImage(parser, key, file.Data, file.Size, source, length, instructions, labels, headers, instructionCount, labelCount, headerCount);
+		URCL_CloseSourceFile(&file);
 
-		if ((length > 0) && (*source == '\n'))
+		if (read)
 		{
-			source++;
-			length--;
+			URCL_free(path);
+			return true;
 		}
 	}
-	
-	void* shrunk = URCL_realloc(*instructions, resultLength * sizeof(URCL_InstructionInfo));
-	if (shrunk != 0) *instructions = (URCL_InstructionInfo*)shrunk;
 
-	shrunk = URCL_realloc(*labels, labelsLength * sizeof(URCL_LabelInfo));
-	if (shrunk != 0) *labels = (URCL_LabelInfo*)shrunk;
+	parser->CacheDirectory = 0;
+	bool parsed = URCL_TryParseSourceParallel(parser, source, length, chunkCount, runner, runnerData, instructions, labels, headers, instructionCount, labelCount, headerCount);
+	parser->CacheDirectory = directory;
 
-	shrunk = URCL_realloc(*headers, headersLength * sizeof(URCL_InstructionInfo));
-	if (shrunk != 0) *headers = (URCL_InstructionInfo*)shrunk;
+	void* image = 0;
+	size_t imageSize = 0;
+	struct URCL_ErrorInfo error = parser->Error;
 
-	*instructionCount = resultLength;
-	*labelCount = labelsLength;
-	*headerCount = headersLength;
-	return true;
+	if (parsed && (path != 0) && URCL_TryWriteProgramImage(parser, key, source, length, *instructions, *labels, *headers, *instructionCount, *labelCount, *headerCount, &image, &imageSize))
+	{
+		char* temporaryPath = URCL_GetCachePath(directory, key ^ (unsigned long long)getpid(), ".tmp");
+
+		if (temporaryPath != 0)
+		{
+			if (!URCL_TryWriteFile(temporaryPath, image, imageSize) || (rename(temporaryPath, path) != 0)) unlink(temporaryPath);
+
+			URCL_free(temporaryPath);
+		}
+
+		URCL_free(image);
+	}
+
+	parser->Error = error;
+	URCL_free(path);
+	return parsed;
 }
+#endif
 
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,24 @@
+#ifdef URCL_Utf8
+	#error The C++ interface uses UTF-16 strings and does not support URCL_Utf8.
+#endif
+
+#if !defined(URCL_NoDependencies) && !defined(URCL_NoFiles) && (defined(__unix__) || defined(__APPLE__))
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#if !defined(URCL_NoDependencies) && !defined(URCL_NoSimd) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+	#include <emmintrin.h>
+#endif
+
+#include <atomic>
 #include <exception>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace URCL
@@ -28,12 +47,50 @@ namespace URCL
 			return result;
 		}
 
+		unsigned long URCL_GetOpcodeFromString(std::wstring str)
+		{
+			URCL_Char name[URCL_MaxOpcodeNameLength];
+			size_t length = str.length();
+			if (length > URCL_MaxOpcodeNameLength) return URCL_Opcode_Unknown;
+
+			for (size_t i = 0; i < length; i++) name[i] = (URCL_Char)str[i];
+			return URCL_GetOpcode(name, length);
+		}
+
 		std::wstring URCL_CharsToString(const URCL_Char* chars, size_t length)
 		{
 			std::wstring result = std::wstring(length, '\0');
 			for (size_t i = 0; i < length; i++) result[i] = (wchar_t)chars[i];
 			return result;
 		}
+
+		struct URCL_ThreadTasks
+		{
+			void (*Task)(void* context, size_t index);
+			void* Context;
+			size_t Count;
+			std::atomic<size_t> Next;
+		};
+
+		void URCL_RunThreadTasks(URCL_ThreadTasks* tasks)
+		{
+			for (size_t i = tasks->Next++; i < tasks->Count; i = tasks->Next++) tasks->Task(tasks->Context, i);
+		}
+
+		void URCL_RunTasksOnThreads(void* data, void (*task)(void* context, size_t index), void* context, size_t count)
+		{
+			unsigned int threadCount = *(unsigned int*)data;
+			URCL_ThreadTasks tasks;
+			tasks.Task = task;
+			tasks.Context = context;
+			tasks.Count = count;
+			tasks.Next = 0;
+
+			std::vector<std::thread> threads;
+			for (unsigned int i = 1; (i < threadCount) && (i < count); i++) threads.push_back(std::thread(URCL_RunThreadTasks, &tasks));
+			URCL_RunThreadTasks(&tasks);
+			for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+		}
 	}
 }
 
@@ -84,8 +141,8 @@ namespace URCL
 	{
 		private:
 			std::wstring Message;
-			unsigned long Position;
-			unsigned long Length;
+			size_t Position;
+			size_t Length;
 
 		public:
 			////type ctor
@@ -103,7 +160,7 @@ namespace URCL
 			////class ParserError
 			////namespace URCL
 			////description Creates a ParserError with the specified message, source position, and source length.
-			ParserError(std::wstring message, unsigned long position, unsigned long length)
+			ParserError(std::wstring message, size_t position, size_t length)
 			{
 				Message = message;
 				Position = position;
@@ -159,6 +216,168 @@ namespace URCL
 		Any = URCL_OperandType_Any
 	};
 
+	////namespace URCL
+	////description Specifies known URCL instructions and headers.
+	////fieldref Unknown urcl.h::URCL_Opcode_Unknown Specifies an unknown operation.
+	////fieldref Add urcl.h::URCL_Opcode_Add Specifies the ADD instruction.
+	////fieldref Rsh urcl.h::URCL_Opcode_Rsh Specifies the RSH instruction.
+	////fieldref Lod urcl.h::URCL_Opcode_Lod Specifies the LOD instruction.
+	////fieldref Str urcl.h::URCL_Opcode_Str Specifies the STR instruction.
+	////fieldref Bge urcl.h::URCL_Opcode_Bge Specifies the BGE instruction.
+	////fieldref Nor urcl.h::URCL_Opcode_Nor Specifies the NOR instruction.
+	////fieldref Imm urcl.h::URCL_Opcode_Imm Specifies the IMM instruction.
+	////fieldref Sub urcl.h::URCL_Opcode_Sub Specifies the SUB instruction.
+	////fieldref Jmp urcl.h::URCL_Opcode_Jmp Specifies the JMP instruction.
+	////fieldref Mov urcl.h::URCL_Opcode_Mov Specifies the MOV instruction.
+	////fieldref Nop urcl.h::URCL_Opcode_Nop Specifies the NOP instruction.
+	////fieldref Lsh urcl.h::URCL_Opcode_Lsh Specifies the LSH instruction.
+	////fieldref Inc urcl.h::URCL_Opcode_Inc Specifies the INC instruction.
+	////fieldref Dec urcl.h::URCL_Opcode_Dec Specifies the DEC instruction.
+	////fieldref Neg urcl.h::URCL_Opcode_Neg Specifies the NEG instruction.
+	////fieldref And urcl.h::URCL_Opcode_And Specifies the AND instruction.
+	////fieldref Or urcl.h::URCL_Opcode_Or Specifies the OR instruction.
+	////fieldref Not urcl.h::URCL_Opcode_Not Specifies the NOT instruction.
+	////fieldref Xnor urcl.h::URCL_Opcode_Xnor Specifies the XNOR instruction.
+	////fieldref Xor urcl.h::URCL_Opcode_Xor Specifies the XOR instruction.
+	////fieldref Nand urcl.h::URCL_Opcode_Nand Specifies the NAND instruction.
+	////fieldref Brl urcl.h::URCL_Opcode_Brl Specifies the BRL instruction.
+	////fieldref Brg urcl.h::URCL_Opcode_Brg Specifies the BRG instruction.
+	////fieldref Bre urcl.h::URCL_Opcode_Bre Specifies the BRE instruction.
+	////fieldref Bne urcl.h::URCL_Opcode_Bne Specifies the BNE instruction.
+	////fieldref Bod urcl.h::URCL_Opcode_Bod Specifies the BOD instruction.
+	////fieldref Bev urcl.h::URCL_Opcode_Bev Specifies the BEV instruction.
+	////fieldref Ble urcl.h::URCL_Opcode_Ble Specifies the BLE instruction.
+	////fieldref Brz urcl.h::URCL_Opcode_Brz Specifies the BRZ instruction.
+	////fieldref Bnz urcl.h::URCL_Opcode_Bnz Specifies the BNZ instruction.
+	////fieldref Brn urcl.h::URCL_Opcode_Brn Specifies the BRN instruction.
+	////fieldref Brp urcl.h::URCL_Opcode_Brp Specifies the BRP instruction.
+	////fieldref Psh urcl.h::URCL_Opcode_Psh Specifies the PSH instruction.
+	////fieldref Pop urcl.h::URCL_Opcode_Pop Specifies the POP instruction.
+	////fieldref Cal urcl.h::URCL_Opcode_Cal Specifies the CAL instruction.
+	////fieldref Ret urcl.h::URCL_Opcode_Ret Specifies the RET instruction.
+	////fieldref Hlt urcl.h::URCL_Opcode_Hlt Specifies the HLT instruction.
+	////fieldref Cpy urcl.h::URCL_Opcode_Cpy Specifies the CPY instruction.
+	////fieldref Brc urcl.h::URCL_Opcode_Brc Specifies the BRC instruction.
+	////fieldref Bnc urcl.h::URCL_Opcode_Bnc Specifies the BNC instruction.
+	////fieldref Mlt urcl.h::URCL_Opcode_Mlt Specifies the MLT instruction.
+	////fieldref Div urcl.h::URCL_Opcode_Div Specifies the DIV instruction.
+	////fieldref Mod urcl.h::URCL_Opcode_Mod Specifies the MOD instruction.
+	////fieldref Bsr urcl.h::URCL_Opcode_Bsr Specifies the BSR instruction.
+	////fieldref Bsl urcl.h::URCL_Opcode_Bsl Specifies the BSL instruction.
+	////fieldref Srs urcl.h::URCL_Opcode_Srs Specifies the SRS instruction.
+	////fieldref Bss urcl.h::URCL_Opcode_Bss Specifies the BSS instruction.
+	////fieldref Sete urcl.h::URCL_Opcode_Sete Specifies the SETE instruction.
+	////fieldref Setne urcl.h::URCL_Opcode_Setne Specifies the SETNE instruction.
+	////fieldref Setg urcl.h::URCL_Opcode_Setg Specifies the SETG instruction.
+	////fieldref Setl urcl.h::URCL_Opcode_Setl Specifies the SETL instruction.
+	////fieldref Setge urcl.h::URCL_Opcode_Setge Specifies the SETGE instruction.
+	////fieldref Setle urcl.h::URCL_Opcode_Setle Specifies the SETLE instruction.
+	////fieldref Setc urcl.h::URCL_Opcode_Setc Specifies the SETC instruction.
+	////fieldref Setnc urcl.h::URCL_Opcode_Setnc Specifies the SETNC instruction.
+	////fieldref Llod urcl.h::URCL_Opcode_Llod Specifies the LLOD instruction.
+	////fieldref Lstr urcl.h::URCL_Opcode_Lstr Specifies the LSTR instruction.
+	////fieldref Sdiv urcl.h::URCL_Opcode_Sdiv Specifies the SDIV instruction.
+	////fieldref Sbrl urcl.h::URCL_Opcode_Sbrl Specifies the SBRL instruction.
+	////fieldref Sbrg urcl.h::URCL_Opcode_Sbrg Specifies the SBRG instruction.
+	////fieldref Sble urcl.h::URCL_Opcode_Sble Specifies the SBLE instruction.
+	////fieldref Sbge urcl.h::URCL_Opcode_Sbge Specifies the SBGE instruction.
+	////fieldref Ssetl urcl.h::URCL_Opcode_Ssetl Specifies the SSETL instruction.
+	////fieldref Ssetg urcl.h::URCL_Opcode_Ssetg Specifies the SSETG instruction.
+	////fieldref Ssetle urcl.h::URCL_Opcode_Ssetle Specifies the SSETLE instruction.
+	////fieldref Ssetge urcl.h::URCL_Opcode_Ssetge Specifies the SSETGE instruction.
+	////fieldref Abs urcl.h::URCL_Opcode_Abs Specifies the ABS instruction.
+	////fieldref Umlt urcl.h::URCL_Opcode_Umlt Specifies the UMLT instruction.
+	////fieldref Sumlt urcl.h::URCL_Opcode_Sumlt Specifies the SUMLT instruction.
+	////fieldref In urcl.h::URCL_Opcode_In Specifies the IN instruction.
+	////fieldref Out urcl.h::URCL_Opcode_Out Specifies the OUT instruction.
+	////fieldref Dw urcl.h::URCL_Opcode_Dw Specifies the DW instruction.
+	////fieldref Bits urcl.h::URCL_Opcode_Bits Specifies the BITS header.
+	////fieldref MinimumRegisters urcl.h::URCL_Opcode_MinimumRegisters Specifies the MINREG header.
+	////fieldref MinimumHeap urcl.h::URCL_Opcode_MinimumHeap Specifies the MINHEAP header.
+	////fieldref MinimumStack urcl.h::URCL_Opcode_MinimumStack Specifies the MINSTACK header.
+	////fieldref InstructionStorage urcl.h::URCL_Opcode_InstructionStorage Specifies the RUN header.
+	enum class Opcode : unsigned long
+	{
+		Unknown = URCL_Opcode_Unknown,
+		Add = URCL_Opcode_Add,
+		Rsh = URCL_Opcode_Rsh,
+		Lod = URCL_Opcode_Lod,
+		Str = URCL_Opcode_Str,
+		Bge = URCL_Opcode_Bge,
+		Nor = URCL_Opcode_Nor,
+		Imm = URCL_Opcode_Imm,
+		Sub = URCL_Opcode_Sub,
+		Jmp = URCL_Opcode_Jmp,
+		Mov = URCL_Opcode_Mov,
+		Nop = URCL_Opcode_Nop,
+		Lsh = URCL_Opcode_Lsh,
+		Inc = URCL_Opcode_Inc,
+		Dec = URCL_Opcode_Dec,
+		Neg = URCL_Opcode_Neg,
+		And = URCL_Opcode_And,
+		Or = URCL_Opcode_Or,
+		Not = URCL_Opcode_Not,
+		Xnor = URCL_Opcode_Xnor,
+		Xor = URCL_Opcode_Xor,
+		Nand = URCL_Opcode_Nand,
+		Brl = URCL_Opcode_Brl,
+		Brg = URCL_Opcode_Brg,
+		Bre = URCL_Opcode_Bre,
+		Bne = URCL_Opcode_Bne,
+		Bod = URCL_Opcode_Bod,
+		Bev = URCL_Opcode_Bev,
+		Ble = URCL_Opcode_Ble,
+		Brz = URCL_Opcode_Brz,
+		Bnz = URCL_Opcode_Bnz,
+		Brn = URCL_Opcode_Brn,
+		Brp = URCL_Opcode_Brp,
+		Psh = URCL_Opcode_Psh,
+		Pop = URCL_Opcode_Pop,
+		Cal = URCL_Opcode_Cal,
+		Ret = URCL_Opcode_Ret,
+		Hlt = URCL_Opcode_Hlt,
+		Cpy = URCL_Opcode_Cpy,
+		Brc = URCL_Opcode_Brc,
+		Bnc = URCL_Opcode_Bnc,
+		Mlt = URCL_Opcode_Mlt,
+		Div = URCL_Opcode_Div,
+		Mod = URCL_Opcode_Mod,
+		Bsr = URCL_Opcode_Bsr,
+		Bsl = URCL_Opcode_Bsl,
+		Srs = URCL_Opcode_Srs,
+		Bss = URCL_Opcode_Bss,
+		Sete = URCL_Opcode_Sete,
+		Setne = URCL_Opcode_Setne,
+		Setg = URCL_Opcode_Setg,
+		Setl = URCL_Opcode_Setl,
+		Setge = URCL_Opcode_Setge,
+		Setle = URCL_Opcode_Setle,
+		Setc = URCL_Opcode_Setc,
+		Setnc = URCL_Opcode_Setnc,
+		Llod = URCL_Opcode_Llod,
+		Lstr = URCL_Opcode_Lstr,
+		Sdiv = URCL_Opcode_Sdiv,
+		Sbrl = URCL_Opcode_Sbrl,
+		Sbrg = URCL_Opcode_Sbrg,
+		Sble = URCL_Opcode_Sble,
+		Sbge = URCL_Opcode_Sbge,
+		Ssetl = URCL_Opcode_Ssetl,
+		Ssetg = URCL_Opcode_Ssetg,
+		Ssetle = URCL_Opcode_Ssetle,
+		Ssetge = URCL_Opcode_Ssetge,
+		Abs = URCL_Opcode_Abs,
+		Umlt = URCL_Opcode_Umlt,
+		Sumlt = URCL_Opcode_Sumlt,
+		In = URCL_Opcode_In,
+		Out = URCL_Opcode_Out,
+		Dw = URCL_Opcode_Dw,
+		Bits = URCL_Opcode_Bits,
+		MinimumRegisters = URCL_Opcode_MinimumRegisters,
+		MinimumHeap = URCL_Opcode_MinimumHeap,
+		MinimumStack = URCL_Opcode_MinimumStack,
+		InstructionStorage = URCL_Opcode_InstructionStorage
+	};
+
 	////namespace URCL
 	////description Specifies types of URCL headers.
 	////field Custom 0 Specifies a user-defined header.
@@ -469,6 +688,7 @@ namespace URCL
 	{
 		private:
 			std::wstring Operation;
+			Opcode OperationCode;
 			std::vector<Operand*> Operands;
 		
 		public:
@@ -477,7 +697,9 @@ namespace URCL
 			////namespace URCL
 			////description Creates an empty instruction.
 			Instruction()
-			{}
+			{
+				OperationCode = Opcode::Unknown;
+			}
 
 			////type ctor
 			////class Instruction
@@ -487,6 +709,17 @@ namespace URCL
 			{
 				Operation = operation;
 				URCL_StringToUpper(&Operation);
+				OperationCode = (Opcode)URCL_GetOpcodeFromString(Operation);
+			}
+
+			////type ctor
+			////class Instruction
+			////namespace URCL
+			////description Creates an instruction with the specified known opcode.
+			Instruction(Opcode opcode)
+			{
+				Operation = URCL_CharsToString(URCL_OpcodeNames[(unsigned long)opcode], URCL_OpcodeNameLengths[(unsigned long)opcode]);
+				OperationCode = opcode;
 			}
 
 			~Instruction()
@@ -502,6 +735,14 @@ namespace URCL
 				return Operation;
 			}
 
+			////class Instruction
+			////namespace URCL
+			////description Returns the opcode for the instruction, or Opcode::Unknown if the operation is not a known instruction or header.
+			Opcode GetOpcode()
+			{
+				return OperationCode;
+			}
+
 			////class Instruction
 			////namespace URCL
 			////description Returns the number of operands in the instruction.
@@ -524,6 +765,7 @@ namespace URCL
 			void SetOperation(std::wstring operation)
 			{
 				Operation = operation;
+				OperationCode = (Opcode)URCL_GetOpcodeFromString(operation);
 			}
 
 			////class Instruction
@@ -672,11 +914,58 @@ namespace URCL
 			std::vector<Instruction*> Instructions;
 			std::vector<Header*> Headers;
 			std::vector<Label*> Labels;
+			std::unordered_map<std::wstring, Label*> LabelIndex;
+			URCL_Parser Parser;
+			URCL_Defines Defines;
+			std::string CacheDirectory;
+			bool HasCacheDirectory;
+			bool IsParserConfigured;
 
 		public:
+			////type ctor
+			////class Program
+			////namespace URCL
+			////description Creates an empty program whose parser follows the global parser settings until GetParser is called. Constants defined with @DEFINE are kept for every later call to AddSource.
+			Program()
+			{
+				URCL_InitDefines(&Defines);
+				HasCacheDirectory = false;
+				IsParserConfigured = false;
+				RefreshParser();
+			}
+
 			~Program()
 			{
 				Clear();
+				URCL_FreeDefines(&Defines);
+			}
+
+			////class Program
+			////namespace URCL
+			////description Returns the parser used by AddSource. The parser can be configured to change the macro handler and target bits for this program only. Once it has been returned, later changes to the global parser settings no longer affect the program.
+			URCL_Parser* GetParser()
+			{
+				RefreshParser();
+				IsParserConfigured = true;
+				return &Parser;
+			}
+
+			////class Program
+			////namespace URCL
+			////description Sets the directory where AddSource caches parse results by the content of their source, or disables caching if the directory is empty. Caching is only available if URCL_Files is defined.
+			void SetCacheDirectory(std::string directory)
+			{
+				CacheDirectory = directory;
+				HasCacheDirectory = true;
+				Parser.CacheDirectory = CacheDirectory.empty() ? 0 : CacheDirectory.c_str();
+			}
+
+			////class Program
+			////namespace URCL
+			////description Removes every constant defined with @DEFINE by previous calls to AddSource.
+			void ClearDefines()
+			{
+				URCL_FreeDefines(&Defines);
 			}
 
 			////class Program
@@ -689,100 +978,161 @@ namespace URCL
 				for (size_t i = 0; i < Headers.size(); i++) delete Headers[i];
 				Instructions.clear();
 				Labels.clear();
+				LabelIndex.clear();
 				Headers.clear();
 			}
 
 			////class Program
 			////namespace URCL
-			////description Parses the specified source and retains the instructions, labels, and headers.
+			////description Parses the specified source and retains the instructions, labels, and headers. Unless GetParser has been called, the source is parsed with the global parser settings at the time of the call.
 			void AddSource(std::wstring source)
 			{
-				unsigned long length = source.length();
+				RefreshParser();
+				AddSource(source, 1, 0, 0);
+			}
+
+			////class Program
+			////namespace URCL
+			////description Parses the specified source on the specified number of threads and retains the instructions, labels, and headers. Uses every hardware thread if the thread count is 0. The results are identical to AddSource, and the parser's macro handlers must be safe to call from multiple threads. The global macro handlers report errors through the global error, so the source is parsed on a single thread if the parser uses them.
+			void AddSourceParallel(std::wstring source, unsigned int threadCount = 0)
+			{
+				if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+				if (threadCount == 0) threadCount = 1;
+
+				RefreshParser();
+				size_t chunkCount = source.length() / URCL_ParallelMinimumChunkLength;
+				if (chunkCount > (size_t)threadCount * URCL_ParallelChunksPerThread) chunkCount = (size_t)threadCount * URCL_ParallelChunksPerThread;
+				if ((Parser.MacroHandler == URCL_InvokeGlobalMacroHandler) || (Parser.MacroOperandHandler == URCL_InvokeGlobalMacroOperandHandler) || (Parser.MacroInstructionHandler == URCL_InvokeGlobalMacroInstructionHandler)) chunkCount = 1;
+
+				AddSource(source, chunkCount, URCL_RunTasksOnThreads, &threadCount);
+			}
+
+			////class Program
+			////namespace URCL
+			////description Parses the specified source like AddSource, but skips each line with an error instead of throwing, and retains the instructions, labels, and headers of the other lines. Returns the errors of the skipped lines. If the specified maximum number of errors is reached, parsing stops and nothing is retained.
+			std::vector<ParserError> AddSourceWithErrors(std::wstring source, size_t maxErrors)
+			{
+				std::vector<URCL_ErrorInfo> errorInfos(maxErrors > 0 ? maxErrors : 1);
+				std::vector<ParserError> errors;
+
+				RefreshParser();
+				URCL_SetParserErrorList(&Parser, errorInfos.data(), maxErrors);
+				try
+				{
+					AddSource(source, 1, 0, 0, &errors);
+				}
+				catch (...)
+				{
+					URCL_SetParserErrorList(&Parser, 0, 0);
+					throw;
+				}
+
+				URCL_SetParserErrorList(&Parser, 0, 0);
+				return errors;
+			}
+
+		private:
+			void RefreshParser()
+			{
+				if (IsParserConfigured) return;
+
+				URCL_InitParserFromGlobals(&Parser);
+				Parser.Defines = &Defines;
+				if (HasCacheDirectory) Parser.CacheDirectory = CacheDirectory.empty() ? 0 : CacheDirectory.c_str();
+			}
+
+			void AddSource(std::wstring source, size_t chunkCount, URCL_TaskRunner runner, void* runnerData, std::vector<ParserError>* errors = 0)
+			{
+				size_t length = source.length();
 				URCL_Char* inputBuffer = new URCL_Char[length];
 				for (size_t i = 0; i < length; i++) inputBuffer[i] = (URCL_Char)source[i];
 
 				URCL_InstructionInfo* instructions;
 				URCL_LabelInfo* labels;
 				URCL_InstructionInfo* headers;
-				unsigned long instructionCount;
-				unsigned long labelsCount;
-				unsigned long headersCount;
+				size_t instructionCount;
+				size_t labelsCount;
+				size_t headersCount;
 
-				if (URCL_TryParseSource(inputBuffer, length, &instructions, &labels, &headers, &instructionCount, &labelsCount, &headersCount))
+				URCL_Arena arena;
+				URCL_InitArena(&arena, 0);
+
+				URCL_ResetParserError(&Parser);
+				Parser.Arena = &arena;
+				Parser.SourceViews = true;
+				bool parsed = URCL_TryParseSourceParallel(&Parser, inputBuffer, length, chunkCount, runner, runnerData, &instructions, &labels, &headers, &instructionCount, &labelsCount, &headersCount);
+				Parser.Arena = 0;
+
+				if (errors != 0)
 				{
-					for (unsigned long i = 0; i < headersCount; i++)
+					for (size_t i = 0; i < Parser.ErrorCount; i++)
 					{
-						URCL_InstructionInfo header = headers[i];
-						std::wstring name = URCL_CharsToString(header.Operation, URCL_CharsLength(header.Operation));
-
-						if (header.Operands[0].Type == URCL_OperandType_None)
-						{
-							AddHeader(name);
-						}
-						else
-						{
-							try
-							{
-								AddHeader(name, GetOperandFromInfo(header.Operands[0]));
-							}
-							catch (ParserError ex)
-							{
-								URCL_FreeInstructions(headers, headersCount);
-								URCL_free(headers);
-								URCL_FreeLabels(labels, labelsCount);
-								URCL_free(labels);
-								URCL_FreeInstructions(instructions, instructionCount);
-								URCL_free(instructions);
-								throw ex;
-							}
-						}
+						URCL_ErrorInfo info = Parser.Errors[i];
+						errors->push_back(ParserError(URCL_CharsToString(info.Message, URCL_CharsLength(info.Message)), info.Position != 0 ? (size_t)(info.Position - inputBuffer) : 0, info.Length));
 					}
 
-					URCL_FreeInstructions(headers, headersCount);
-					URCL_free(headers);
-
-					for (unsigned long i = 0; i < labelsCount; i++)
+					if (!parsed && (Parser.ErrorCount == Parser.MaxErrors) && (Parser.ErrorCount > 0))
 					{
-						URCL_LabelInfo label = labels[i];
-						AddLabel(URCL_CharsToString(label.Name, URCL_CharsLength(label.Name)), label.Address + Instructions.size());
+						URCL_FreeArena(&arena);
+						delete[] inputBuffer;
+						return;
 					}
+				}
 
-					URCL_FreeLabels(labels, labelsCount);
-					URCL_free(labels);
-
-					for (unsigned long i = 0; i < instructionCount; i++)
+				if (parsed)
+				{
+					try
 					{
-						URCL_InstructionInfo instruction = instructions[i];
-						Instruction* instructionObj = new Instruction(URCL_CharsToString(instruction.Operation, URCL_CharsLength(instruction.Operation)));
-						
-						for (unsigned long j = 0; (j < URCL_MaxOperands) && (instruction.Operands[j].Type != URCL_OperandType_None); j++)
+						for (size_t i = 0; i < headersCount; i++)
 						{
-							URCL_OperandInfo operand = instruction.Operands[j];
+							URCL_InstructionInfo header = headers[i];
+							std::wstring name = URCL_CharsToString(header.Operation, header.OperationLength);
 
-							try
-							{
-								instructionObj->AddOperand(GetOperandFromInfo(operand));
-							}
-							catch (ParserError ex)
+							if (header.Operands[0].Type == URCL_OperandType_None) AddHeader(name);
+							else AddHeader(name, GetOperandFromInfo(header.Operands[0]));
+						}
+
+						for (size_t i = 0; i < labelsCount; i++)
+						{
+							URCL_LabelInfo label = labels[i];
+							AddLabel(URCL_CharsToString(label.Name, label.NameLength), label.Address + Instructions.size());
+						}
+
+						for (size_t i = 0; i < instructionCount; i++)
+						{
+							URCL_InstructionInfo instruction = instructions[i];
+							Instruction* instructionObj;
+							if (instruction.Opcode != URCL_Opcode_Unknown) instructionObj = new Instruction((Opcode)instruction.Opcode);
+							else instructionObj = new Instruction(URCL_CharsToString(instruction.Operation, instruction.OperationLength));
+							
+							for (size_t j = 0; (j < URCL_MaxOperands) && (instruction.Operands[j].Type != URCL_OperandType_None); j++)
 							{
-								URCL_FreeInstructions(instructions, instructionCount);
-								URCL_free(instructions);
-								throw ex;
+								instructionObj->AddOperand(GetOperandFromInfo(instruction.Operands[j]));
 							}
-						}
 
-						Emit(instructionObj);
+							Emit(instructionObj);
+						}
+					}
+					catch (ParserError ex)
+					{
+						URCL_FreeArena(&arena);
+						delete[] inputBuffer;
+						throw ex;
 					}
 
-					URCL_FreeInstructions(instructions, instructionCount);
-					URCL_free(instructions);
+					URCL_FreeArena(&arena);
+					delete[] inputBuffer;
 				}
 				else
 				{
-					throw ParserError(URCL_CharsToString(URCL_Error.Message, URCL_CharsLength(URCL_Error.Message)), (unsigned long)(URCL_Error.Position - inputBuffer), URCL_Error.Length);
+					ParserError error = ParserError(URCL_CharsToString(Parser.Error.Message, URCL_CharsLength(Parser.Error.Message)), (size_t)(Parser.Error.Position - inputBuffer), Parser.Error.Length);
+					URCL_FreeArena(&arena);
+					delete[] inputBuffer;
+					throw error;
 				}
 			}
 
+		public:
 			////class Program
 			////namespace URCL
 			////description Adds a header with the specified name.
@@ -886,7 +1236,7 @@ namespace URCL
 			Label* AddLabel(std::wstring name, unsigned long long address)
 			{
 				Label* result = new Label(name, address);
-				Labels.push_back(result);
+				AddLabel(result);
 				return result;
 			}
 
@@ -896,6 +1246,16 @@ namespace URCL
 			void AddLabel(Label* label)
 			{
 				Labels.push_back(label);
+				LabelIndex.emplace(label->GetName(), label);
+			}
+
+			////class Program
+			////namespace URCL
+			////description Returns the first label with the specified name, or null if no such label exists.
+			Label* GetLabel(std::wstring name)
+			{
+				auto entry = LabelIndex.find(name);
+				return (entry != LabelIndex.end()) ? entry->second : nullptr;
 			}
 
 			////class Program
@@ -936,20 +1296,21 @@ namespace URCL
 				switch ((OperandType)operand.Type)
 				{
 					case OperandType::Any:
-						return new AnyOperand(URCL_CharsToString(operand.StringValue, URCL_CharsLength(operand.StringValue)));
+						return new AnyOperand(URCL_CharsToString(operand.StringValue, operand.StringLength));
 					case OperandType::IndexedRegister:
 						return new IndexedRegisterOperand(operand.ImmediateValue);
 					case OperandType::SpecialRegister:
-						return new SpecialRegisterOperand(URCL_CharsToString(operand.StringValue, URCL_CharsLength(operand.StringValue)));
+						return new SpecialRegisterOperand(URCL_CharsToString(operand.StringValue, operand.StringLength));
 					case OperandType::Immediate:
 						return new ImmediateOperand(operand.ImmediateValue);
 					case OperandType::MemoryAddress:
 						return new MemoryAddressOperand(operand.ImmediateValue);
 					case OperandType::Label:
 						{
-							std::wstring labelName = URCL_CharsToString(operand.StringValue, URCL_CharsLength(operand.StringValue));
+							std::wstring labelName = URCL_CharsToString(operand.StringValue, operand.StringLength);
 							
-							for (Label* label : Labels) if (labelName == label->GetName()) return new LabelOperand(label);
+							Label* label = GetLabel(labelName);
+							if (label) return new LabelOperand(label);
 							
 							throw ParserError(L"No label found with the name \"" + labelName + L"\".");
 						}
@@ -958,7 +1319,7 @@ namespace URCL
 						return new RelativeOperand((long long)operand.ImmediateValue);
 						break;
 					case OperandType::Port:
-						return new PortOperand(URCL_CharsToString(operand.StringValue, URCL_CharsLength(operand.StringValue)));
+						return new PortOperand(URCL_CharsToString(operand.StringValue, operand.StringLength));
 						break;
 					default:
 						throw ParserError(L"Unknown operand type was generated.");
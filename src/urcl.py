@@ -16,18 +16,25 @@ class c_OperandInfo(ctypes.Structure):
 	_fields_ = [
 		("Type", ctypes.c_ulong),
 		("ImmediateValue", ctypes.c_ulonglong),
-		("StringValue", c_Char_p)
+		("StringValue", c_Char_p),
+		("StringLength", ctypes.c_size_t),
+		("IsSourceView", ctypes.c_bool)
 	]
 
 class c_InstructionInfo(ctypes.Structure):
 	_fields_ = [
 		("Operation", c_Char_p),
+		("OperationLength", ctypes.c_size_t),
+		("IsSourceView", ctypes.c_bool),
+		("Opcode", ctypes.c_ulong),
 		("Operands", c_OperandInfo * 3)
 	]
 
 class c_LabelInfo(ctypes.Structure):
 	_fields_ = [
 		("Name", c_Char_p),
+		("NameLength", ctypes.c_size_t),
+		("IsSourceView", ctypes.c_bool),
 		("Address", ctypes.c_ulonglong)
 	]
 
@@ -67,15 +74,15 @@ class Program:
 		for i in range(len(source)): sourcePtr[i] = c_Char(ord(source[i]))
 		sourcePtr[len(source)] = c_Char(0)
 
-		length = ctypes.c_ulonglong(len(source))
+		length = ctypes.c_size_t(len(source))
 
 		instructions = c_InstructionInfo_p()
 		labels = c_LabelInfo_p()
 		headers = c_InstructionInfo_p()
 
-		instructionsLength = ctypes.c_ulong()
-		labelsLength = ctypes.c_ulong()
-		headersLength = ctypes.c_ulong()
+		instructionsLength = ctypes.c_size_t()
+		labelsLength = ctypes.c_size_t()
+		headersLength = ctypes.c_size_t()
 
 		if bool(_urcl_lib.URCL_TryParseSource(sourcePtr, length, ctypes.byref(instructions), ctypes.byref(labels), ctypes.byref(headers), ctypes.byref(instructionsLength), ctypes.byref(labelsLength), ctypes.byref(headersLength))):
 			#TODO: Translate from ctypes to Python classes.
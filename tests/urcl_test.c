@@ -0,0 +1,737 @@
+// Regression tests for urcl.h. Build and run from the repository root with:
+// cc -std=c11 -DURCL_NoChar16 -Isrc tests/urcl_test.c -o urcl_test && ./urcl_test
+// The tests also build with -DURCL_Utf8 instead of -DURCL_NoChar16.
+
+#include <stdio.h>
+#include <string.h>
+#include "urcl.h"
+
+int Failures = 0;
+
+#define Check(condition) do { if (!(condition)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Failures++; } } while (0)
+
+URCL_Char* NewSource(const char* text, size_t* length)
+{
+	*length = strlen(text);
+	URCL_Char* result = (URCL_Char*)URCL_malloc((*length + 1) * sizeof(URCL_Char));
+	for (size_t i = 0; i <= *length; i++) result[i] = (unsigned char)text[i];
+	return result;
+}
+
+bool EqualsText(const URCL_Char* value, size_t length, const char* text)
+{
+	if (strlen(text) != length) return false;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		if (value[i] != (unsigned char)text[i]) return false;
+	}
+	return true;
+}
+
+typedef struct ParseResult
+{
+	URCL_InstructionInfo* Instructions;
+	URCL_LabelInfo* Labels;
+	URCL_InstructionInfo* Headers;
+	size_t InstructionCount;
+	size_t LabelCount;
+	size_t HeaderCount;
+} ParseResult;
+
+bool TryParse(URCL_Parser* parser, const URCL_Char* source, size_t length, ParseResult* result)
+{
+	return URCL_TryParseSourceEx(parser, source, length, &(result->Instructions), &(result->Labels), &(result->Headers), &(result->InstructionCount), &(result->LabelCount), &(result->HeaderCount));
+}
+
+void FreeParseResult(ParseResult* result)
+{
+	URCL_FreeInstructions(result->Instructions, result->InstructionCount);
+	URCL_FreeLabels(result->Labels, result->LabelCount);
+	URCL_FreeInstructions(result->Headers, result->HeaderCount);
+	URCL_free(result->Instructions);
+	URCL_free(result->Labels);
+	URCL_free(result->Headers);
+}
+
+void TestDataSegmentLabelAddresses(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("DW [1 2 3]\n.a\nDW 4\nDW 5\n.b\nADD R1 R2 R3\n.c\nDW [6 7]\nDW .a\n.d\nHLT\n", &length);
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	ParseResult words;
+	Check(TryParse(&parser, source, length, &words));
+
+	URCL_DataSegment segment;
+	URCL_InitDataSegment(&segment);
+	parser.DataSegment = &segment;
+	ParseResult ranges;
+	Check(TryParse(&parser, source, length, &ranges));
+
+	Check(words.InstructionCount == 10);
+	Check(ranges.InstructionCount == 6);
+	Check(segment.WordCount == 7);
+	Check(words.LabelCount == 4);
+	Check(ranges.LabelCount == words.LabelCount);
+
+	for (size_t i = 0; (i < words.LabelCount) && (i < ranges.LabelCount); i++) Check(ranges.Labels[i].Address == words.Labels[i].Address);
+	if (words.LabelCount == 4)
+	{
+		Check(words.Labels[0].Address == 3);
+		Check(words.Labels[1].Address == 5);
+		Check(words.Labels[2].Address == 6);
+		Check(words.Labels[3].Address == 9);
+	}
+
+	FreeParseResult(&words);
+	FreeParseResult(&ranges);
+	URCL_FreeDataSegment(&segment);
+	URCL_free(source);
+}
+
+void TestBasicMacroOperandString(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("IMM R1 @MAX\nIMM R2 @bits\n", &length);
+
+	for (int sourceViews = 0; sourceViews <= 1; sourceViews++)
+	{
+		URCL_Parser parser;
+		URCL_InitParser(&parser);
+		parser.TargetBits = 8;
+		parser.SourceViews = sourceViews;
+		ParseResult result;
+		Check(TryParse(&parser, source, length, &result));
+		Check(result.InstructionCount == 2);
+
+		if (result.InstructionCount == 2)
+		{
+			URCL_OperandInfo* max = &(result.Instructions[0].Operands[1]);
+			Check(max->Type == URCL_OperandType_Immediate);
+			Check(max->ImmediateValue == 0xFF);
+			Check(max->IsSourceView == (bool)sourceViews);
+			Check(EqualsText(max->StringValue, max->StringLength, "@MAX"));
+			if (sourceViews) Check(max->StringValue == source + 7);
+
+			URCL_OperandInfo* bits = &(result.Instructions[1].Operands[1]);
+			Check(bits->ImmediateValue == 8);
+			Check(EqualsText(bits->StringValue, bits->StringLength, "@bits"));
+		}
+
+		FreeParseResult(&result);
+	}
+
+	URCL_free(source);
+}
+
+bool TryParseAtBits(const char* text, unsigned long bits, URCL_Parser* parser)
+{
+	size_t length;
+	URCL_Char* source = NewSource(text, &length);
+	URCL_InitParser(parser);
+	URCL_SetParserTargetBits(parser, bits);
+
+	ParseResult result;
+	bool parsed = TryParse(parser, source, length, &result);
+	if (parsed) FreeParseResult(&result);
+	URCL_free(source);
+	return parsed;
+}
+
+void TestOperandTargetWidth(void)
+{
+	URCL_Parser parser;
+	Check(TryParseAtBits("IMM R1 255\nLOD R1 #255\nLOD R1 M255\nJMP ~+127\nJMP ~-128\nMINHEAP 1000\n", 8, &parser));
+
+	const char* tooLarge[] = { "IMM R1 256\n", "LOD R1 #256\n", "STR M256 R1\n", "JMP ~+128\n", "JMP ~-129\n", "DW [1 #300]\n" };
+	for (size_t i = 0; i < (sizeof(tooLarge) / sizeof(tooLarge[0])); i++)
+	{
+		Check(!TryParseAtBits(tooLarge[i], 8, &parser));
+		Check(parser.Error.Message == URCL_Error_ImmediateTooLarge);
+		Check(TryParseAtBits(tooLarge[i], 16, &parser));
+	}
+}
+
+void TestAllocationLimitCoversSourceMapAndColumns(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("BITS 16\n.start\nIMM R1 1\nADD R1 R1 R2\nDW [1 2 3 4 5 6 7 8]\nJMP .start\nHLT\n", &length);
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	ParseResult result;
+	Check(TryParse(&parser, source, length, &result));
+	FreeParseResult(&result);
+	size_t parseBytes = parser.AllocatedBytes;
+
+	URCL_ParserLimits limits;
+	URCL_InitParserLimits(&limits);
+	limits.MaxAllocatedBytes = parseBytes;
+
+	URCL_SourceMap map;
+	URCL_InitSourceMap(&map);
+	URCL_InitParser(&parser);
+	URCL_SetParserLimits(&parser, &limits);
+	parser.SourceMap = &map;
+	Check(!TryParse(&parser, source, length, &result));
+	Check(parser.Error.Message == URCL_Error_AllocationLimit);
+	URCL_FreeSourceMap(&map);
+
+	URCL_ProgramColumns columns;
+	URCL_InitParser(&parser);
+	Check(URCL_TryParseSourceColumns(&parser, source, length, &columns));
+	URCL_FreeProgramColumns(&columns);
+	limits.MaxAllocatedBytes = parser.AllocatedBytes - 1;
+
+	URCL_InitParser(&parser);
+	URCL_SetParserLimits(&parser, &limits);
+	Check(!URCL_TryParseSourceColumns(&parser, source, length, &columns));
+	Check(parser.Error.Message == URCL_Error_AllocationLimit);
+	URCL_free(source);
+
+	char text[2048] = "@DEFINE V .a_long_label_name_that_grows_the_pool\n";
+	for (int i = 0; i < 20; i++) strcat(text, "IMM R1 @V\n");
+	source = NewSource(text, &length);
+	strcat(text, "//");
+	for (int i = 0; i < 20; i++) strcat(text, " a comment that leaves the pool at its capacity");
+	size_t paddedLength;
+	URCL_Char* padded = NewSource(text, &paddedLength);
+
+	URCL_Defines defines;
+	URCL_InitDefines(&defines);
+	URCL_InitParser(&parser);
+	parser.Defines = &defines;
+	Check(URCL_TryParseSourceColumns(&parser, source, length, &columns));
+	Check(columns.PoolLength > length);
+	URCL_FreeProgramColumns(&columns);
+	size_t grownBytes = parser.AllocatedBytes;
+
+	URCL_FreeDefines(&defines);
+	URCL_InitDefines(&defines);
+	URCL_InitParser(&parser);
+	parser.Defines = &defines;
+	Check(URCL_TryParseSourceColumns(&parser, padded, paddedLength, &columns));
+	Check(columns.PoolLength <= paddedLength);
+	URCL_FreeProgramColumns(&columns);
+	Check((grownBytes + ((paddedLength - length) * sizeof(URCL_Char))) > parser.AllocatedBytes);
+
+	URCL_FreeDefines(&defines);
+	URCL_InitDefines(&defines);
+	limits.MaxAllocatedBytes = grownBytes - 1;
+	URCL_InitParser(&parser);
+	URCL_SetParserLimits(&parser, &limits);
+	parser.Defines = &defines;
+	Check(!URCL_TryParseSourceColumns(&parser, source, length, &columns));
+	Check(parser.Error.Message == URCL_Error_AllocationLimit);
+
+	URCL_FreeDefines(&defines);
+	URCL_free(padded);
+	URCL_free(source);
+}
+
+void TestProgramImageChecksSource(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource(".a\nIMM R1 1\nJMP .a\n", &length);
+	size_t otherLength;
+	URCL_Char* other = NewSource(".b\nIMM R2 2\nJMP .b\n", &otherLength);
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	ParseResult parsed;
+	Check(TryParse(&parser, source, length, &parsed));
+
+	void* image = 0;
+	size_t imageSize = 0;
+	Check(URCL_TryWriteProgramImage(&parser, 42, source, length, parsed.Instructions, parsed.Labels, parsed.Headers, parsed.InstructionCount, parsed.LabelCount, parsed.HeaderCount, &image, &imageSize));
+	FreeParseResult(&parsed);
+
+	ParseResult read;
+	Check(URCL_TryReadProgramImage(&parser, 42, image, imageSize, source, length, &(read.Instructions), &(read.Labels), &(read.Headers), &(read.InstructionCount), &(read.LabelCount), &(read.HeaderCount)));
+	Check((read.InstructionCount == 2) && (read.LabelCount == 1));
+	if (read.LabelCount == 1) Check(EqualsText(read.Labels[0].Name, read.Labels[0].NameLength, ".a"));
+	FreeParseResult(&read);
+
+	Check(otherLength == length);
+	Check(!URCL_TryReadProgramImage(&parser, 42, image, imageSize, other, otherLength, &(read.Instructions), &(read.Labels), &(read.Headers), &(read.InstructionCount), &(read.LabelCount), &(read.HeaderCount)));
+	Check(parser.Error.Message == URCL_Error_InvalidImage);
+
+	URCL_free(image);
+	URCL_free(other);
+	URCL_free(source);
+}
+
+void TestDocumentEditShiftsLaterPositions(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("IMM R1 1\n.a\nJMP .a\n.b\nHLT\n", &length);
+	size_t insertedLength;
+	URCL_Char* inserted = NewSource("DW [1 2 3]\n", &insertedLength);
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	URCL_Document document;
+	URCL_InitDocument(&document, &parser);
+	Check(URCL_TryParseDocument(&document, source, length));
+	Check(URCL_TryEditDocument(&document, 0, 0, inserted, insertedLength));
+	Check(URCL_TryEditDocument(&document, length + insertedLength, 0, inserted, insertedLength));
+
+	Check(document.InstructionCount == 9);
+	Check(document.LabelCount == 2);
+	if (document.LabelCount == 2)
+	{
+		Check(URCL_GetDocumentLabelAddress(&document, 0) == 4);
+		Check(URCL_GetDocumentLabelAddress(&document, 1) == 5);
+	}
+	Check(document.StatementCount == 7);
+	if (document.StatementCount == 7) Check(URCL_GetDocumentStatementStart(&document, 5) == (length + insertedLength - 4));
+
+	URCL_ResolveDocumentPositions(&document);
+	if (document.LabelCount == 2) Check((document.Labels[0].Address == 4) && (document.Labels[1].Address == 5));
+	if (document.StatementCount == 7) Check(document.Statements[5].Start == (length + insertedLength - 4));
+
+	URCL_FreeDocument(&document);
+	URCL_free(inserted);
+	URCL_free(source);
+}
+
+void TestDocumentEditSkipsClosedComments(void)
+{
+	char text[1024] = "IMM R1 1 // see /* here\nMOV R1/*x R2\nDW [1 /* 2 */ 3] // /*\n";
+	for (int i = 0; i < 40; i++) strcat(text, "ADD R1 R2 R3\n");
+	strcat(text, "HLT\n");
+
+	size_t length;
+	URCL_Char* source = NewSource(text, &length);
+	size_t insertedLength;
+	URCL_Char* inserted = NewSource("NOP\n", &insertedLength);
+
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	URCL_Document document;
+	URCL_InitDocument(&document, &parser);
+	Check(URCL_TryParseDocument(&document, source, length));
+	Check(document.ParsedStatementCount == 44);
+
+	Check(URCL_TryEditDocument(&document, length - 4, 0, inserted, insertedLength));
+	Check(document.ParsedStatementCount <= 2);
+	Check(document.InstructionCount == 46);
+	Check(document.StatementCount == 45);
+
+	URCL_FreeDocument(&document);
+	URCL_free(inserted);
+	URCL_free(source);
+}
+
+void TestLexTokensAndResume(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("@DEFINE N 5\n.start // entry\nADD R1, $2 /* a\nb */ @N\nLOD R3 M4\nJMP ~-2\n", &length);
+
+	const unsigned long kinds[] = { URCL_TokenKind_Macro, URCL_TokenKind_Macro, URCL_TokenKind_Operand, URCL_TokenKind_Label, URCL_TokenKind_Comment, URCL_TokenKind_Operation, URCL_TokenKind_Operand, URCL_TokenKind_Separator, URCL_TokenKind_Operand, URCL_TokenKind_Comment, URCL_TokenKind_Macro, URCL_TokenKind_Operation, URCL_TokenKind_Operand, URCL_TokenKind_Operand, URCL_TokenKind_Operation, URCL_TokenKind_Operand };
+	const size_t offsets[] = { 0, 8, 10, 12, 19, 28, 32, 34, 36, 39, 49, 52, 56, 59, 62, 66 };
+	const size_t lengths[] = { 7, 1, 1, 6, 8, 3, 2, 1, 2, 9, 2, 3, 2, 2, 3, 3 };
+	const unsigned long operandTypes[] = { URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_Immediate, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_IndexedRegister, URCL_OperandType_None, URCL_OperandType_IndexedRegister, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_IndexedRegister, URCL_OperandType_MemoryAddress, URCL_OperandType_None, URCL_OperandType_Relative };
+	const size_t tokenCount = sizeof(kinds) / sizeof(kinds[0]);
+
+	URCL_Lexer lexer;
+	URCL_InitLexer(&lexer, source, length, 0);
+	URCL_Token tokens[32];
+	size_t count = URCL_Lex(&lexer, tokens, 32);
+	Check(count == tokenCount);
+	Check(URCL_Lex(&lexer, tokens + count, 1) == 0);
+
+	for (size_t i = 0; (i < count) && (i < tokenCount); i++)
+	{
+		Check(tokens[i].Kind == kinds[i]);
+		Check(tokens[i].Offset == offsets[i]);
+		Check(tokens[i].Length == lengths[i]);
+		Check(tokens[i].OperandType == operandTypes[i]);
+	}
+
+	for (size_t capacity = 1; capacity <= 3; capacity++)
+	{
+		URCL_InitLexer(&lexer, source, length, 0);
+		size_t total = 0;
+		size_t found;
+		while ((found = URCL_Lex(&lexer, tokens + total, capacity)) != 0)
+		{
+			Check(found <= capacity);
+			for (size_t i = total; (i < (total + found)) && (i < tokenCount); i++) Check((tokens[i].Kind == kinds[i]) && (tokens[i].Offset == offsets[i]) && (tokens[i].OperandType == operandTypes[i]));
+			total += found;
+			if (total > tokenCount) break;
+		}
+		Check(total == tokenCount);
+	}
+
+	URCL_InitLexer(&lexer, source, length, 52);
+	count = URCL_Lex(&lexer, tokens, 32);
+	Check(count == 5);
+	for (size_t i = 0; (i < count) && (i < 5); i++) Check((tokens[i].Kind == kinds[i + 11]) && (tokens[i].Offset == offsets[i + 11]) && (tokens[i].OperandType == operandTypes[i + 11]));
+
+	URCL_free(source);
+}
+
+void TestLexDataArray(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("DW [1 .a,@MAX /* c */ R2]\nADD [1 2]\n", &length);
+
+	URCL_Lexer lexer;
+	URCL_InitLexer(&lexer, source, length, 0);
+	URCL_Token tokens[16];
+	size_t count = URCL_Lex(&lexer, tokens, 16);
+
+	const unsigned long kinds[] = { URCL_TokenKind_Operation, URCL_TokenKind_Separator, URCL_TokenKind_Operand, URCL_TokenKind_Operand, URCL_TokenKind_Separator, URCL_TokenKind_Macro, URCL_TokenKind_Comment, URCL_TokenKind_Operand, URCL_TokenKind_Separator, URCL_TokenKind_Operation, URCL_TokenKind_Operand, URCL_TokenKind_Operand };
+	const size_t offsets[] = { 0, 3, 4, 6, 8, 9, 14, 22, 24, 26, 30, 33 };
+	const size_t lengths[] = { 2, 1, 1, 2, 1, 4, 7, 2, 1, 3, 2, 2 };
+	const unsigned long operandTypes[] = { URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_Immediate, URCL_OperandType_Label, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_IndexedRegister, URCL_OperandType_None, URCL_OperandType_None, URCL_OperandType_Any, URCL_OperandType_Any };
+
+	Check(count == 12);
+	for (size_t i = 0; (i < count) && (i < 12); i++)
+	{
+		Check(tokens[i].Kind == kinds[i]);
+		Check(tokens[i].Offset == offsets[i]);
+		Check(tokens[i].Length == lengths[i]);
+		Check(tokens[i].OperandType == operandTypes[i]);
+	}
+
+	URCL_free(source);
+}
+
+void CheckSameParse(const URCL_Char* source, size_t length, size_t chunkCount)
+{
+	URCL_Parser sequentialParser;
+	URCL_InitParser(&sequentialParser);
+	ParseResult sequential;
+	bool sequentialParsed = TryParse(&sequentialParser, source, length, &sequential);
+
+	URCL_Parser parallelParser;
+	URCL_InitParser(&parallelParser);
+	ParseResult parallel;
+	bool parallelParsed = URCL_TryParseSourceParallel(&parallelParser, source, length, chunkCount, 0, 0, &(parallel.Instructions), &(parallel.Labels), &(parallel.Headers), &(parallel.InstructionCount), &(parallel.LabelCount), &(parallel.HeaderCount));
+
+	Check(parallelParsed == sequentialParsed);
+	if (!parallelParsed || !sequentialParsed)
+	{
+		Check(parallelParser.Error.Message == sequentialParser.Error.Message);
+		Check(parallelParser.Error.Position == sequentialParser.Error.Position);
+		Check(parallelParser.Error.Length == sequentialParser.Error.Length);
+		if (parallelParsed) FreeParseResult(&parallel);
+		if (sequentialParsed) FreeParseResult(&sequential);
+		return;
+	}
+
+	Check(parallel.InstructionCount == sequential.InstructionCount);
+	Check(parallel.HeaderCount == sequential.HeaderCount);
+	Check(parallel.LabelCount == sequential.LabelCount);
+	for (size_t i = 0; (i < parallel.LabelCount) && (i < sequential.LabelCount); i++)
+	{
+		Check(parallel.Labels[i].Address == sequential.Labels[i].Address);
+		Check((parallel.Labels[i].NameLength == sequential.Labels[i].NameLength) && (memcmp(parallel.Labels[i].Name, sequential.Labels[i].Name, parallel.Labels[i].NameLength * sizeof(URCL_Char)) == 0));
+	}
+	for (size_t i = 0; (i < parallel.InstructionCount) && (i < sequential.InstructionCount); i++)
+	{
+		Check(parallel.Instructions[i].Opcode == sequential.Instructions[i].Opcode);
+		Check(parallel.Instructions[i].Operands[1].ImmediateValue == sequential.Instructions[i].Operands[1].ImmediateValue);
+	}
+
+	FreeParseResult(&parallel);
+	FreeParseResult(&sequential);
+}
+
+void TestParallelParseMatchesSequential(void)
+{
+	static char text[16384];
+	text[0] = 0;
+	strcat(text, "BITS 16\n");
+	for (int i = 0; i < 60; i++)
+	{
+		char line[128];
+		sprintf(line, ".l%d\n/* comment %d\n .x\n HLT */ IMM R1 %d\nHLT // see /* here\n", i, i, i);
+		strcat(text, line);
+		if ((i % 7) == 3) strcat(text, "DW [1 /* two\n lines */ 2]\n// alone /* open\nJMP .x */\n");
+		sprintf(line, "JMP .l%d\n", i);
+		strcat(text, line);
+	}
+
+	const char* errors[] = { "", "IMM R1 99999999999999999999\n", "DW [1 2\n", "/* unclosed\n" };
+	const size_t chunkCounts[] = { 2, 3, 7, 16, 64 };
+	size_t textLength = strlen(text);
+
+	for (size_t e = 0; e < (sizeof(errors) / sizeof(errors[0])); e++)
+	{
+		static char source[16384];
+		size_t split = textLength;
+		if (e != 0) split = (size_t)(strchr(strstr(text + (textLength * e / 4), "\nJMP .l") + 1, '\n') + 1 - text);
+		memcpy(source, text, split);
+		strcpy(source + split, errors[e]);
+		strcat(source, text + split);
+
+		size_t length;
+		URCL_Char* value = NewSource(source, &length);
+		for (size_t c = 0; c < (sizeof(chunkCounts) / sizeof(chunkCounts[0])); c++) CheckSameParse(value, length, chunkCounts[c]);
+		URCL_free(value);
+	}
+}
+
+bool ExpandStopMacro(URCL_Parser* parser, void* data, const URCL_Char* name, size_t nameLength, URCL_InstructionInfo* result)
+{
+	(void)parser;
+	(void)data;
+	if (!EqualsText(name, nameLength, "@STOP")) return false;
+
+	result->Operation = (URCL_Char*)URCL_Text("HLT");
+	result->OperationLength = 3;
+	return true;
+}
+
+void TestSkimMatchesParse(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("BITS 16\nMINREG 8\n.a\n@DEFINE K 3\nIMM R1 @K\n@STOP\n.b\nDW [1 2 .a]\nDW 4\n.c\nJMP .b\nMINHEAP 32\n.d\n", &length);
+
+	URCL_Defines parseDefines;
+	URCL_InitDefines(&parseDefines);
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	URCL_SetParserTypedMacroHandler(&parser, 0, ExpandStopMacro, 0);
+	parser.Defines = &parseDefines;
+	ParseResult parsed;
+	Check(TryParse(&parser, source, length, &parsed));
+
+	URCL_Defines skimDefines;
+	URCL_InitDefines(&skimDefines);
+	parser.Defines = &skimDefines;
+	URCL_LabelInfo* labels;
+	URCL_InstructionInfo* headers;
+	size_t labelCount;
+	size_t headerCount;
+	size_t instructionCount;
+	Check(URCL_TrySkimSourceEx(&parser, source, length, &labels, &headers, &labelCount, &headerCount, &instructionCount));
+
+	Check((parsed.InstructionCount == 7) && (parsed.LabelCount == 4) && (parsed.HeaderCount == 3));
+	Check(instructionCount == parsed.InstructionCount);
+	Check(labelCount == parsed.LabelCount);
+	for (size_t i = 0; (i < labelCount) && (i < parsed.LabelCount); i++)
+	{
+		Check(labels[i].Address == parsed.Labels[i].Address);
+		Check((labels[i].NameLength == parsed.Labels[i].NameLength) && (memcmp(labels[i].Name, parsed.Labels[i].Name, labels[i].NameLength * sizeof(URCL_Char)) == 0));
+	}
+	Check(headerCount == parsed.HeaderCount);
+	for (size_t i = 0; (i < headerCount) && (i < parsed.HeaderCount); i++)
+	{
+		Check(headers[i].Opcode == parsed.Headers[i].Opcode);
+		Check(headers[i].Operands[0].ImmediateValue == parsed.Headers[i].Operands[0].ImmediateValue);
+	}
+
+	URCL_FreeLabels(labels, labelCount);
+	URCL_FreeInstructions(headers, headerCount);
+	URCL_free(labels);
+	URCL_free(headers);
+	URCL_FreeDefines(&skimDefines);
+	URCL_FreeDefines(&parseDefines);
+	FreeParseResult(&parsed);
+	URCL_free(source);
+}
+
+unsigned long FindOpcode(const URCL_Char* name, size_t length)
+{
+	for (unsigned long opcode = 1; opcode < URCL_OpcodeCount; opcode++)
+	{
+		if (URCL_IsStringEqualCaseInsensitive(URCL_OpcodeNames[opcode], URCL_OpcodeNameLengths[opcode], name, length)) return opcode;
+	}
+	return URCL_Opcode_Unknown;
+}
+
+void TestGetOpcode(void)
+{
+	for (unsigned long opcode = 1; opcode < URCL_OpcodeCount; opcode++)
+	{
+		URCL_Char name[16];
+		size_t length = URCL_OpcodeNameLengths[opcode];
+		memcpy(name, URCL_OpcodeNames[opcode], length * sizeof(URCL_Char));
+		Check(URCL_GetOpcode(name, length) == opcode);
+
+		for (size_t i = 0; i < length; i++) name[i] = (URCL_Char)(name[i] | 0x20);
+		Check(URCL_GetOpcode(name, length) == opcode);
+
+		Check(URCL_GetOpcode(name, length - 1) == FindOpcode(name, length - 1));
+		name[length] = 'X';
+		Check(URCL_GetOpcode(name, length + 1) == FindOpcode(name, length + 1));
+
+		for (size_t i = 0; i < length; i++)
+		{
+			URCL_Char original = name[i];
+			name[i] = (URCL_Char)(original ^ 0x40);
+			Check(URCL_GetOpcode(name, length) == URCL_Opcode_Unknown);
+			name[i] = (URCL_Char)(original + 1);
+			Check(URCL_GetOpcode(name, length) == FindOpcode(name, length));
+			name[i] = original;
+		}
+	}
+
+	const char* misses[] = { "", "A", "ADDD", "MINSTACKS", "@ADD", ".ADD", "AD D", "JMP1" };
+	for (size_t i = 0; i < (sizeof(misses) / sizeof(misses[0])); i++)
+	{
+		size_t length;
+		URCL_Char* name = NewSource(misses[i], &length);
+		Check(URCL_GetOpcode(name, length) == URCL_Opcode_Unknown);
+		URCL_free(name);
+	}
+}
+
+void TestErrorListRecovery(void)
+{
+	size_t length;
+	URCL_Char* source = NewSource("IMM R1 1\nIMM R1 99999999999999999999\nADD R1 R2 R3\nDW [1 2\nHLT\nIMM R2 3\n.a\nJMP .a\n", &length);
+
+	struct URCL_ErrorInfo errors[4];
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	URCL_SetParserErrorList(&parser, errors, 4);
+	ParseResult result;
+	Check(TryParse(&parser, source, length, &result));
+	Check(parser.ErrorCount == 2);
+	Check(result.InstructionCount == 5);
+	Check(result.LabelCount == 1);
+	if (result.LabelCount == 1) Check(result.Labels[0].Address == 4);
+	FreeParseResult(&result);
+
+	if (parser.ErrorCount == 2)
+	{
+		Check(errors[0].Message == URCL_Error_ImmediateTooLarge);
+		Check((errors[0].Position == source + 16) && (errors[0].Length == 20));
+		Check(errors[1].Message == URCL_Error_ExpectedArrayEnd);
+		Check((errors[1].Position == source + 57) && (errors[1].Length == 0));
+	}
+
+	URCL_LabelInfo* labels;
+	URCL_InstructionInfo* headers;
+	size_t labelCount;
+	size_t headerCount;
+	size_t instructionCount;
+	URCL_SetParserErrorList(&parser, errors, 4);
+	Check(URCL_TrySkimSourceEx(&parser, source, length, &labels, &headers, &labelCount, &headerCount, &instructionCount));
+	Check((parser.ErrorCount == 1) && (instructionCount == 6));
+	if (labelCount == 1) Check(labels[0].Address == 5);
+	URCL_FreeLabels(labels, labelCount);
+	URCL_FreeInstructions(headers, headerCount);
+	URCL_free(labels);
+	URCL_free(headers);
+
+	for (size_t maxErrors = 1; maxErrors <= 2; maxErrors++)
+	{
+		URCL_InitParser(&parser);
+		URCL_SetParserErrorList(&parser, errors, maxErrors);
+		Check(!TryParse(&parser, source, length, &result));
+		Check(parser.ErrorCount == maxErrors);
+		Check(parser.Error.Message == errors[maxErrors - 1].Message);
+		Check(parser.Error.Position == errors[maxErrors - 1].Position);
+	}
+
+	URCL_free(source);
+}
+
+void RunTasksInReverse(void* data, void (*task)(void* context, size_t index), void* context, size_t count)
+{
+	(void)data;
+	for (size_t i = count; i > 0; i--) task(context, i - 1);
+}
+
+bool TryParseWithDefines(const char* text, URCL_Defines* defines, size_t chunkCount, const char* cacheDirectory, ParseResult* result)
+{
+	size_t length;
+	URCL_Char* source = NewSource(text, &length);
+	URCL_Parser parser;
+	URCL_InitParser(&parser);
+	parser.Defines = defines;
+	parser.SourceViews = false;
+	parser.CacheDirectory = cacheDirectory;
+
+	bool parsed = URCL_TryParseSourceParallel(&parser, source, length, chunkCount, RunTasksInReverse, 0, &(result->Instructions), &(result->Labels), &(result->Headers), &(result->InstructionCount), &(result->LabelCount), &(result->HeaderCount));
+#ifdef URCL_Files
+	if (cacheDirectory != 0)
+	{
+		char* path = URCL_GetCachePath(cacheDirectory, URCL_GetSourceKey(&parser, source, length), ".urclc");
+		URCL_SourceFile file;
+		bool cached = URCL_TryLoadFile(path, &file);
+		Check(!cached);
+		if (cached)
+		{
+			URCL_CloseSourceFile(&file);
+			unlink(path);
+		}
+		URCL_free(path);
+	}
+#endif
+	URCL_free(source);
+	return parsed;
+}
+
+void TestDefines(void)
+{
+	URCL_Defines defines;
+	URCL_InitDefines(&defines);
+	ParseResult result;
+
+	Check(TryParseWithDefines("@DEFINE X 5\nIMM R1 @X\n@define @X 7\nIMM R2 @X\n", &defines, 1, 0, &result));
+	Check(result.InstructionCount == 2);
+	if (result.InstructionCount == 2) Check((result.Instructions[0].Operands[1].ImmediateValue == 5) && (result.Instructions[1].Operands[1].ImmediateValue == 7));
+	FreeParseResult(&result);
+
+	Check(TryParseWithDefines("IMM R3 @X\nIMM R4 @X\n", &defines, 4, 0, &result));
+	Check(result.InstructionCount == 2);
+	if (result.InstructionCount == 2) Check((result.Instructions[0].Operands[1].ImmediateValue == 7) && (result.Instructions[1].Operands[1].ImmediateValue == 7));
+	FreeParseResult(&result);
+
+	static char text[4096];
+	text[0] = 0;
+	for (int i = 0; i < 50; i++) strcat(text, "IMM R1 1\n");
+	strcat(text, "@DEFINE Y 9\n");
+	for (int i = 0; i < 50; i++) strcat(text, "IMM R1 @Y\n");
+	URCL_FreeDefines(&defines);
+	URCL_InitDefines(&defines);
+	Check(TryParseWithDefines(text, &defines, 8, 0, &result));
+	Check(result.InstructionCount == 100);
+	if (result.InstructionCount == 100) Check((result.Instructions[49].Operands[1].ImmediateValue == 1) && (result.Instructions[99].Operands[1].ImmediateValue == 9));
+	FreeParseResult(&result);
+
+#ifdef URCL_Files
+	Check(TryParseWithDefines("IMM R1 @Y\n", &defines, 1, ".", &result));
+	if (result.InstructionCount == 1) Check(result.Instructions[0].Operands[1].ImmediateValue == 9);
+	FreeParseResult(&result);
+
+	Check(TryParseWithDefines("@DEFINE Y 3\n", &defines, 1, ".", &result));
+	FreeParseResult(&result);
+
+	Check(TryParseWithDefines("IMM R1 @Y\n", &defines, 1, ".", &result));
+	if (result.InstructionCount == 1) Check(result.Instructions[0].Operands[1].ImmediateValue == 3);
+	FreeParseResult(&result);
+#endif
+
+	URCL_FreeDefines(&defines);
+}
+
+int main(void)
+{
+	TestDataSegmentLabelAddresses();
+	TestBasicMacroOperandString();
+	TestOperandTargetWidth();
+	TestAllocationLimitCoversSourceMapAndColumns();
+	TestProgramImageChecksSource();
+	TestDocumentEditShiftsLaterPositions();
+	TestDocumentEditSkipsClosedComments();
+	TestLexTokensAndResume();
+	TestLexDataArray();
+	TestParallelParseMatchesSequential();
+	TestSkimMatchesParse();
+	TestGetOpcode();
+	TestErrorListRecovery();
+	TestDefines();
+
+	if (Failures == 0) printf("All tests passed.\n");
+	return (Failures == 0) ? 0 : 1;
+}